@@ -3,6 +3,7 @@
 #include "FlowAsset.h"
 
 #include "FlowLogChannels.h"
+#include "FlowProfiling.h"
 #include "FlowSettings.h"
 #include "FlowSubsystem.h"
 
@@ -13,6 +14,7 @@
 #include "Nodes/Route/FlowNode_Start.h"
 #include "Nodes/Route/FlowNode_SubGraph.h"
 
+#include "Algo/Reverse.h"
 #include "Engine/World.h"
 #include "Serialization/MemoryReader.h"
 #include "Serialization/MemoryWriter.h"
@@ -30,6 +32,13 @@ FString UFlowAsset::ValidationError_NullNodeInstance = TEXT("Node with GUID {0}
 UFlowAsset::UFlowAsset(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, bWorldBound(true)
+	, StartPriority(0)
+	, bInstantiateNodesOnDemand(false)
+	, InstancePoolSize(0)
+	, InstancePoolWarmup(0)
+	, PreloadDistance(0)
+	, MaxPredictivePreloads(0)
+	, PinRecordCapacity(32)
 #if WITH_EDITOR
 	, FlowGraph(nullptr)
 #endif
@@ -38,6 +47,10 @@ UFlowAsset::UFlowAsset(const FObjectInitializer& ObjectInitializer)
 	, bStartNodePlacedAsGhostNode(false)
 	, TemplateAsset(nullptr)
 	, FinishPolicy(EFlowFinishPolicy::Keep)
+	, bQueueSignals(false)
+	, bDrainingSignals(false)
+	, bAbortedBySignalLimit(false)
+	, bShareStatelessNodes(false)
 {
 	if (!AssetGuid.IsValid())
 	{
@@ -47,6 +60,37 @@ UFlowAsset::UFlowAsset(const FObjectInitializer& ObjectInitializer)
 	ExpectedOwnerClass = UFlowSettings::Get()->GetDefaultExpectedOwnerClass();
 }
 
+void UFlowAsset::PostLoad()
+{
+	Super::PostLoad();
+
+#if WITH_EDITOR
+	// If we removed or moved a flow node blueprint (and there is no redirector) we might loose the reference to it resulting
+	// in null pointers in the Nodes FGUID->UFlowNode* Map. So here we iterate over all the Nodes and remove all pairs that
+	// are nulled out.
+	
+	TSet<FGuid> NodesToRemoveGUID;
+
+	for (auto& [Guid, Node] : GetNodes())
+	{
+		if (!IsValid(Node))
+		{
+			NodesToRemoveGUID.Emplace(Guid);
+		}
+	}
+
+	for (const FGuid& Guid : NodesToRemoveGUID)
+	{
+		UnregisterNode(Guid);
+	}
+#endif
+
+	if (!HasAnyFlags(RF_ClassDefaultObject))
+	{
+		CompileGraph();
+	}
+}
+
 #if WITH_EDITOR
 void UFlowAsset::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
 {
@@ -78,30 +122,6 @@ void UFlowAsset::PostDuplicate(bool bDuplicateForPIE)
 	}
 }
 
-void UFlowAsset::PostLoad()
-{
-	Super::PostLoad();
-
-	// If we removed or moved a flow node blueprint (and there is no redirector) we might loose the reference to it resulting
-	// in null pointers in the Nodes FGUID->UFlowNode* Map. So here we iterate over all the Nodes and remove all pairs that
-	// are nulled out.
-	
-	TSet<FGuid> NodesToRemoveGUID;
-
-	for (auto& [Guid, Node] : GetNodes())
-	{
-		if (!IsValid(Node))
-		{
-			NodesToRemoveGUID.Emplace(Guid);
-		}
-	}
-
-	for (const FGuid& Guid : NodesToRemoveGUID)
-	{
-		UnregisterNode(Guid);
-	}
-}
-
 EDataValidationResult UFlowAsset::ValidateAsset(FFlowMessageLog& MessageLog)
 {
 	// validate nodes
@@ -373,11 +393,22 @@ void UFlowAsset::HarvestNodeConnections()
 			Node->PostEditChange();
 		}
 	}
+
+	// pins might have changed even if connections didn't
+	if (bGraphDirty || (CompiledGraph.IsValid() && !CompiledGraph->IsUpToDate(Nodes)))
+	{
+		InvalidateCompiledGraph();
+	}
 }
 #endif
 
 UFlowNode* UFlowAsset::GetDefaultEntryNode() const
 {
+	if (CompiledGraph.IsValid())
+	{
+		return GetNodeByIndex(CompiledGraph->DefaultEntryNode);
+	}
+
 	UFlowNode* FirstStartNode = nullptr;
 
 	for (const TPair<FGuid, UFlowNode*>& Node : Nodes)
@@ -435,6 +466,12 @@ void UFlowAsset::RemoveCustomOutput(const FName& EventName)
 
 UFlowNode_CustomInput* UFlowAsset::TryFindCustomInputNodeByEventName(const FName& EventName) const
 {
+	if (CompiledGraph.IsValid())
+	{
+		const TConstArrayView<int32> FoundNodes = CompiledGraph->FindCustomInputNodes(EventName);
+		return FoundNodes.Num() > 0 ? Cast<UFlowNode_CustomInput>(GetNodeByIndex(FoundNodes[0])) : nullptr;
+	}
+
 	for (UFlowNode_CustomInput* InputNode : CustomInputNodes)
 	{
 		if (IsValid(InputNode) && InputNode->GetEventName() == EventName)
@@ -448,6 +485,12 @@ UFlowNode_CustomInput* UFlowAsset::TryFindCustomInputNodeByEventName(const FName
 
 UFlowNode_CustomOutput* UFlowAsset::TryFindCustomOutputNodeByEventName(const FName& EventName) const
 {
+	if (CompiledGraph.IsValid())
+	{
+		const TConstArrayView<int32> FoundNodes = CompiledGraph->FindCustomOutputNodes(EventName);
+		return FoundNodes.Num() > 0 ? Cast<UFlowNode_CustomOutput>(GetNodeByIndex(FoundNodes[0])) : nullptr;
+	}
+
 	for (const TPair<FGuid, UFlowNode*>& Node : Nodes)
 	{
 		if (UFlowNode_CustomOutput* CustomOutput = Cast<UFlowNode_CustomOutput>(Node.Value))
@@ -466,6 +509,11 @@ TArray<FName> UFlowAsset::GatherCustomInputNodeEventNames() const
 {
 	// Runtime-safe gathering of the CustomInputs (which is editor-only data)
 	//  from the actual flow nodes
+	if (CompiledGraph.IsValid())
+	{
+		return CompiledGraph->CustomInputNames;
+	}
+
 	TArray<FName> Results;
 
 	for (const TPair<FGuid, UFlowNode*>& Node : Nodes)
@@ -483,6 +531,11 @@ TArray<FName> UFlowAsset::GatherCustomOutputNodeEventNames() const
 {
 	// Runtime-safe gathering of the CustomOutputs (which is editor-only data)
 	//  from the actual flow nodes
+	if (CompiledGraph.IsValid())
+	{
+		return CompiledGraph->CustomOutputNames;
+	}
+
 	TArray<FName> Results;
 
 	for (const TPair<FGuid, UFlowNode*>& Node : Nodes)
@@ -514,9 +567,45 @@ TArray<UFlowNode*> UFlowAsset::GetNodesInExecutionOrder(UFlowNode* FirstIterated
 	return FoundNodes;
 }
 
+const TSharedPtr<const FFlowCompiledGraph>& UFlowAsset::GetCompiledGraph()
+{
+	if (!CompiledGraph.IsValid())
+	{
+		CompileGraph();
+	}
+
+	return CompiledGraph;
+}
+
+void UFlowAsset::InvalidateCompiledGraph()
+{
+	CompiledGraph.Reset();
+	IndexedNodes.Reset();
+}
+
+void UFlowAsset::CompileGraph()
+{
+	const TSharedRef<FFlowCompiledGraph> NewCompiledGraph = MakeShared<FFlowCompiledGraph>();
+	NewCompiledGraph->Build(Nodes, UFlowSettings::Get()->bOptimizeCompiledGraph && !GIsEditor);
+
+	UE_CLOG(NewCompiledGraph->NumUnreachableNodes > 0, LogFlow, Verbose, TEXT("Compiled %s: folded %d nodes, %d nodes unreachable"),
+		*GetName(), NewCompiledGraph->NumFoldedNodes, NewCompiledGraph->NumUnreachableNodes);
+
+	IndexedNodes.SetNumZeroed(NewCompiledGraph->Num());
+	for (int32 NodeIndex = 0; NodeIndex < NewCompiledGraph->Num(); NodeIndex++)
+	{
+		UFlowNode* Node = Nodes.FindRef(NewCompiledGraph->Nodes[NodeIndex].NodeGuid);
+		Node->CompiledIndex = NodeIndex;
+		IndexedNodes[NodeIndex] = Node;
+	}
+
+	CompiledGraph = NewCompiledGraph;
+}
+
 void UFlowAsset::AddInstance(UFlowAsset* Instance)
 {
 	ActiveInstances.Add(Instance);
+	FLOW_INC_GAUGE(LiveInstances, 1);
 }
 
 int32 UFlowAsset::RemoveInstance(UFlowAsset* Instance)
@@ -528,7 +617,12 @@ int32 UFlowAsset::RemoveInstance(UFlowAsset* Instance)
 	}
 #endif
 
-	ActiveInstances.Remove(Instance);
+	if (ActiveInstances.Remove(Instance) > 0)
+	{
+		FLOW_DEC_GAUGE(LiveInstances, 1);
+		FLOW_INC_COUNTER(InstancesDestroyed);
+	}
+
 	return ActiveInstances.Num();
 }
 
@@ -541,15 +635,27 @@ void UFlowAsset::ClearInstances()
 	}
 #endif
 
-	for (int32 i = ActiveInstances.Num() - 1; i >= 0; i--)
+	// finishing instance removes it from the set, also finishing its SubGraph instances
+	// nodes might start new instances while finishing, these are finished in the next pass
+	static constexpr int32 MaxPasses = 8;
+	for (int32 Pass = 0; Pass < MaxPasses && ActiveInstances.Num() > 0; Pass++)
 	{
-		if (ActiveInstances.IsValidIndex(i) && ActiveInstances[i])
+		const TArray<UFlowAsset*> InstancesToFinish = ActiveInstances.Array();
+		for (int32 i = InstancesToFinish.Num() - 1; i >= 0; i--)
 		{
-			ActiveInstances[i]->FinishFlow(EFlowFinishPolicy::Keep);
+			if (InstancesToFinish[i] && ActiveInstances.Contains(InstancesToFinish[i]))
+			{
+				InstancesToFinish[i]->FinishFlow(EFlowFinishPolicy::Keep);
+			}
 		}
 	}
 
-	ActiveInstances.Empty();
+	if (ActiveInstances.Num() > 0)
+	{
+		UE_LOG(LogFlow, Error, TEXT("%d instances of %s kept starting new instances while clearing them, dropping them without finishing."), ActiveInstances.Num(), *GetName());
+		FLOW_DEC_GAUGE(LiveInstances, ActiveInstances.Num());
+		ActiveInstances.Empty();
+	}
 }
 
 #if WITH_EDITOR
@@ -599,30 +705,245 @@ void UFlowAsset::BroadcastRuntimeMessageAdded(const TSharedRef<FTokenizedMessage
 void UFlowAsset::InitializeInstance(const TWeakObjectPtr<UObject> InOwner, UFlowAsset* InTemplateAsset)
 {
 	Owner = InOwner;
+
+	CreateNodeInstances(InTemplateAsset);
+	InitializeNodeInstances();
+}
+
+void UFlowAsset::ReinitializeInstance(const TWeakObjectPtr<UObject> InOwner)
+{
+	Owner = InOwner;
+
+	// settings might have changed since the instance was created
+	bQueueSignals = UFlowSettings::Get()->bQueueSignals;
+	SignalLimiter.Initialize(UFlowSettings::Get()->MaxSignalDepth, UFlowSettings::Get()->MaxInstanceSignalsPerFrame, UFlowSettings::Get()->SignalLimitPolicy);
+	PreloadPredictor.Initialize(TemplateAsset->PreloadDistance, TemplateAsset->MaxPredictivePreloads, CompiledGraph->Num());
+
+	InitializeNodeInstances();
+}
+
+void UFlowAsset::ResetInstance()
+{
+	Owner.Reset();
+	NodeOwningThisAssetInstance.Reset();
+	ActiveSubGraphs.Empty();
+
+	FinishPolicy = EFlowFinishPolicy::Keep;
+	SignalQueue.Empty();
+	SignalLimiter.Reset();
+	bAbortedBySignalLimit = false;
+	PreloadPredictor.Reset();
+
+	ResetNodes();
+}
+
+bool UFlowAsset::CanPoolInstances() const
+{
+	for (const TPair<FGuid, UFlowNode*>& Node : Nodes)
+	{
+		if (Node.Value && !Node.Value->IsReusable())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void UFlowAsset::CreateNodeInstances(UFlowAsset* InTemplateAsset)
+{
 	TemplateAsset = InTemplateAsset;
 
+	CompiledGraph = TemplateAsset->GetCompiledGraph();
+	IndexedNodes.SetNumZeroed(CompiledGraph->Num());
+	ActiveNodeBits.Init(false, CompiledGraph->Num());
+	ActiveNodeSlots.Init(INDEX_NONE, CompiledGraph->Num());
+	RecordedNodeBits.Init(false, CompiledGraph->Num());
+
+	bQueueSignals = UFlowSettings::Get()->bQueueSignals;
+	bShareStatelessNodes = UFlowSettings::Get()->bShareStatelessNodes;
+	SignalLimiter.Initialize(UFlowSettings::Get()->MaxSignalDepth, UFlowSettings::Get()->MaxInstanceSignalsPerFrame, UFlowSettings::Get()->SignalLimitPolicy);
+	PreloadPredictor.Initialize(TemplateAsset->PreloadDistance, TemplateAsset->MaxPredictivePreloads, CompiledGraph->Num());
+
 	for (TPair<FGuid, UFlowNode*>& Node : Nodes)
 	{
-		UFlowNode* NewNodeInstance = NewObject<UFlowNode>(this, Node.Value->GetClass(), NAME_None, RF_Transient, Node.Value, false, nullptr);
-		Node.Value = NewNodeInstance;
+		const int32 NodeIndex = CompiledGraph->FindNodeIndex(Node.Key);
+		if (IndexedNodes.IsValidIndex(NodeIndex))
+		{
+			IndexedNodes[NodeIndex] = Node.Value;
+		}
+
+		if (CanShareNode(NodeIndex, Node.Value))
+		{
+			continue;
+		}
+		// entry nodes are always instantiated, as graph can be started from them without passing a signal
+		// unreachable nodes are instantiated on demand, if anything triggers them directly
+		else if (Node.Value->IsA<UFlowNode_Start>() || Node.Value->IsA<UFlowNode_CustomInput>()
+			|| (!bInstantiateNodesOnDemand && CompiledGraph->IsReachable(NodeIndex)))
+		{
+			InstantiateNode(Node.Key, Node.Value);
+		}
+	}
+}
+
+void UFlowAsset::InitializeNodeInstances()
+{
+	for (const TPair<FGuid, UFlowNode*>& Node : Nodes)
+	{
+		if (IsNodeInstantiated(Node.Value))
+		{
+			Node.Value->InitializeInstance();
+		}
+	}
+}
+
+bool UFlowAsset::CanShareNode(const FGuid& NodeGuid, const UFlowNode* TemplateNode) const
+{
+	return CanShareNode(CompiledGraph->FindNodeIndex(NodeGuid), TemplateNode);
+}
+
+bool UFlowAsset::CanShareNode(const int32 NodeIndex, const UFlowNode* TemplateNode) const
+{
+	// template node index has to match the compiled graph used by this instance, it might be outdated after editing the asset during PIE
+	return bShareStatelessNodes && TemplateNode->IsStateless() && TemplateNode->CompiledIndex != INDEX_NONE
+		&& TemplateNode->CompiledIndex == NodeIndex;
+}
+
+UFlowNode* UFlowAsset::InstantiateNode(const FGuid& NodeGuid, UFlowNode*& Node)
+{
+	UFlowNode* NewNodeInstance = NewObject<UFlowNode>(this, Node->GetClass(), NAME_None, RF_Transient, Node, false, nullptr);
+	Node = NewNodeInstance;
+
+	NewNodeInstance->CompiledIndex = CompiledGraph->FindNodeIndex(NodeGuid);
+	if (IndexedNodes.IsValidIndex(NewNodeInstance->CompiledIndex))
+	{
+		IndexedNodes[NewNodeInstance->CompiledIndex] = NewNodeInstance;
+	}
 
-		if (UFlowNode_CustomInput* CustomInput = Cast<UFlowNode_CustomInput>(NewNodeInstance))
+	if (UFlowNode_CustomInput* CustomInput = Cast<UFlowNode_CustomInput>(NewNodeInstance))
+	{
+		if (!CustomInput->EventName.IsNone())
 		{
-			if (!CustomInput->EventName.IsNone())
+			CustomInputNodes.Emplace(CustomInput);
+		}
+	}
+
+	return NewNodeInstance;
+}
+
+UFlowNode* UFlowAsset::GetNodeInstance(const FGuid& NodeGuid)
+{
+	UFlowNode** Node = Nodes.Find(NodeGuid);
+	if (Node == nullptr || *Node == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (TemplateAsset && !IsNodeInstantiated(*Node) && !CanShareNode(NodeGuid, *Node))
+	{
+		UFlowNode* NewNodeInstance = InstantiateNode(NodeGuid, *Node);
+		NewNodeInstance->InitializeInstance();
+		return NewNodeInstance;
+	}
+
+	return *Node;
+}
+
+UFlowNode* UFlowAsset::GetNodeInstanceByIndex(const int32 NodeIndex)
+{
+	if (!IndexedNodes.IsValidIndex(NodeIndex))
+	{
+		return nullptr;
+	}
+
+	UFlowNode* Node = IndexedNodes[NodeIndex];
+	if (Node && TemplateAsset && !IsNodeInstantiated(Node) && !CanShareNode(NodeIndex, Node))
+	{
+		const FGuid& NodeGuid = CompiledGraph->Nodes[NodeIndex].NodeGuid;
+
+		Node = InstantiateNode(NodeGuid, Nodes.FindChecked(NodeGuid));
+		Node->InitializeInstance();
+	}
+
+	return Node;
+}
+
+UFlowNode* UFlowAsset::PreloadNode(const FGuid& NodeGuid)
+{
+	UFlowNode* Node = GetNodeInstance(NodeGuid);
+	if (Node && !PreloadedNodes.Contains(Node))
+	{
+		PreloadedNodes.Emplace(Node);
+		Node->TriggerPreload();
+	}
+
+	return Node;
+}
+
+void UFlowAsset::UpdatePreloadWindow()
+{
+	if (!PreloadPredictor.IsEnabled() || PreloadPredictor.bUpdating || !CompiledGraph.IsValid())
+	{
+		return;
+	}
+
+	FLOW_TRACE_SCOPE("FlowAsset::UpdatePreloadWindow");
+	TGuardValue<bool> UpdatingGuard(PreloadPredictor.bUpdating, true);
+
+	PreloadPredictor.Update(*CompiledGraph, ActiveNodeBits);
+
+	for (const int32 NodeIndex : PreloadPredictor.GetLeftNodes())
+	{
+		if (PreloadPredictor.PreloadedBits[NodeIndex])
+		{
+			PreloadPredictor.PreloadedBits[NodeIndex] = false;
+
+			UFlowNode* Node = IndexedNodes[NodeIndex];
+			if (Node && PreloadedNodes.Remove(Node) > 0)
 			{
-				CustomInputNodes.Emplace(CustomInput);
+				Node->TriggerFlush();
 			}
 		}
+	}
 
-		NewNodeInstance->InitializeInstance();
+	for (const int32 NodeIndex : PreloadPredictor.GetEnteredNodes())
+	{
+		// node is already running, it's too late for preloading
+		if (ActiveNodeBits[NodeIndex])
+		{
+			continue;
+		}
+
+		// stateless template nodes don't have any content
+		UFlowNode* Node = GetNodeInstanceByIndex(NodeIndex);
+		if (Node && !IsSharedNode(Node) && !PreloadedNodes.Contains(Node))
+		{
+			PreloadedNodes.Emplace(Node);
+			PreloadPredictor.PreloadedBits[NodeIndex] = true;
+			Node->TriggerPreload();
+		}
 	}
 }
 
+void UFlowAsset::FlushPreloadedNode(UFlowNode* Node)
+{
+	PreloadedNodes.Remove(Node);
+
+	// node stays in the preload window, so it isn't preloaded again until it leaves the window
+	if (PreloadPredictor.PreloadedBits.IsValidIndex(Node->GetCompiledIndex()))
+	{
+		PreloadPredictor.PreloadedBits[Node->GetCompiledIndex()] = false;
+	}
+
+	Node->TriggerFlush();
+}
+
 void UFlowAsset::DeinitializeInstance()
 {
 	for (const TPair<FGuid, UFlowNode*>& Node : Nodes)
 	{
-		if (IsValid(Node.Value))
+		if (IsValid(Node.Value) && IsNodeInstantiated(Node.Value))
 		{
 			Node.Value->DeinitializeInstance();
 		}
@@ -631,9 +952,17 @@ void UFlowAsset::DeinitializeInstance()
 	if (TemplateAsset)
 	{
 		const int32 ActiveInstancesLeft = TemplateAsset->RemoveInstance(this);
-		if (ActiveInstancesLeft == 0 && GetFlowSubsystem())
+
+		// subsystem tearing down all flows removes templates in bulk and empties pools anyway
+		UFlowSubsystem* FlowSubsystem = GetFlowSubsystem();
+		if (FlowSubsystem && !FlowSubsystem->IsTearingDown())
 		{
-			GetFlowSubsystem()->RemoveInstancedTemplate(TemplateAsset);
+			FlowSubsystem->OnInstanceRemoved(TemplateAsset, ActiveInstancesLeft);
+
+			if (TemplateAsset->InstancePoolSize > 0)
+			{
+				FlowSubsystem->ReleaseFlowInstance(this);
+			}
 		}
 	}
 }
@@ -641,6 +970,7 @@ void UFlowAsset::DeinitializeInstance()
 void UFlowAsset::PreStartFlow()
 {
 	ResetNodes();
+	bAbortedBySignalLimit = false;
 
 #if WITH_EDITOR
 	if (TemplateAsset->ActiveInstances.Num() == 1)
@@ -662,7 +992,8 @@ void UFlowAsset::StartFlow()
 
 	if (UFlowNode* ConnectedEntryNode = GetDefaultEntryNode())
 	{
-		RecordedNodes.Add(ConnectedEntryNode);
+		FFlowStatelessNodeScope StatelessNodeScope(this, ConnectedEntryNode);
+		RecordNode(ConnectedEntryNode);
 		ConnectedEntryNode->TriggerFirstOutput(true);
 	}
 }
@@ -671,12 +1002,19 @@ void UFlowAsset::FinishFlow(const EFlowFinishPolicy InFinishPolicy, const bool b
 {
 	FinishPolicy = InFinishPolicy;
 
+	// signals can't reach nodes of the finished graph
+	SignalQueue.Empty();
+
 	// end execution of this asset and all of its nodes
 	for (UFlowNode* Node : ActiveNodes)
 	{
+		FFlowStatelessNodeScope StatelessNodeScope(this, Node);
 		Node->Deactivate();
 	}
+	FLOW_DEC_GAUGE(ActiveNodes, ActiveNodes.Num());
 	ActiveNodes.Empty();
+	ActiveNodeBits.Init(false, IndexedNodes.Num());
+	ActiveNodeSlots.Init(INDEX_NONE, IndexedNodes.Num());
 
 	// flush preloaded content
 	for (UFlowNode* PreloadedNode : PreloadedNodes)
@@ -684,6 +1022,7 @@ void UFlowAsset::FinishFlow(const EFlowFinishPolicy InFinishPolicy, const bool b
 		PreloadedNode->TriggerFlush();
 	}
 	PreloadedNodes.Empty();
+	PreloadPredictor.Reset();
 
 	// provides option to finish game-specific logic prior to removing asset instance 
 	if (bRemoveInstance)
@@ -724,11 +1063,24 @@ void UFlowAsset::TriggerCustomInput_FromSubGraph(UFlowNode_SubGraph* Node, const
 
 void UFlowAsset::TriggerCustomInput(const FName& EventName)
 {
+	if (CompiledGraph.IsValid())
+	{
+		for (const int32 NodeIndex : CompiledGraph->FindCustomInputNodes(EventName))
+		{
+			if (UFlowNode_CustomInput* CustomInput = Cast<UFlowNode_CustomInput>(GetNodeInstanceByIndex(NodeIndex)))
+			{
+				RecordNode(CustomInput);
+				CustomInput->ExecuteInput(EventName);
+			}
+		}
+		return;
+	}
+
 	for (UFlowNode_CustomInput* CustomInput : CustomInputNodes)
 	{
 		if (CustomInput->EventName == EventName)
 		{
-			RecordedNodes.Add(CustomInput);
+			RecordNode(CustomInput);
 			CustomInput->ExecuteInput(EventName);
 		}
 	}
@@ -751,23 +1103,296 @@ void UFlowAsset::TriggerCustomOutput(const FName& EventName)
 
 void UFlowAsset::TriggerInput(const FGuid& NodeGuid, const FName& PinName)
 {
-	if (UFlowNode* Node = Nodes.FindRef(NodeGuid))
+	if (UFlowNode* Node = GetNodeInstance(NodeGuid))
 	{
-		if (!ActiveNodes.Contains(Node))
+		FFlowStatelessNodeScope StatelessNodeScope(this, Node);
+		AddActiveNode(Node);
+		Node->TriggerInput(PinName);
+	}
+}
+
+void UFlowAsset::TriggerConnectedInput(const UFlowNode* FromNode, const int32 OutputPinIndex)
+{
+	const FFlowCompiledConnection* Connection = CompiledGraph.IsValid() ? CompiledGraph->FindConnection(FromNode->CompiledIndex, OutputPinIndex) : nullptr;
+	if (Connection == nullptr)
+	{
+		// node isn't known to the compiled graph, fall back to resolving connection by name
+		const FName& PinName = FromNode->OutputPins[OutputPinIndex].PinName;
+		if (const FConnectedPin* ConnectedPin = FromNode->Connections.Find(PinName))
 		{
-			ActiveNodes.Add(Node);
-			RecordedNodes.Add(Node);
+			TriggerInput(ConnectedPin->NodeGuid, ConnectedPin->PinName);
 		}
+		return;
+	}
 
-		Node->TriggerInput(PinName);
+	if (Connection->IsConnected())
+	{
+		if (bQueueSignals)
+		{
+			QueueSignal(*Connection);
+		}
+		else
+		{
+			ExecuteSignal(*Connection);
+		}
+	}
+}
+
+void UFlowAsset::QueueSignal(const FFlowCompiledConnection& Signal)
+{
+	if (bDrainingSignals)
+	{
+		// triggered by the node currently executed in DrainSignalQueue, it will be processed right after this node
+		SignalQueue.Push(Signal);
+	}
+	else
+	{
+		// triggered from outside of the queue processing, i.e. by latent node, so it goes after signals deferred to the next frame
+		SignalQueue.Insert(Signal, 0);
+
+		// time spent on the drain counts towards the frame budget, the same as starting Root Flow
+		UFlowSubsystem* FlowSubsystem = GetFlowSubsystem();
+		if (FlowSubsystem)
+		{
+			FlowSubsystem->BeginBudgetedWork();
+		}
+
+		DrainSignalQueue();
+
+		if (FlowSubsystem)
+		{
+			FlowSubsystem->EndBudgetedWork();
+		}
+	}
+}
+
+void UFlowAsset::ExecuteSignal(const FFlowCompiledConnection& Signal)
+{
+	if (!CheckSignalLimits(Signal))
+	{
+		return;
+	}
+
+	if (UFlowNode* Node = GetNodeInstanceByIndex(Signal.NodeIndex))
+	{
+		TGuardValue<int32> DepthGuard(SignalLimiter.Depth, SignalLimiter.Depth + 1);
+		FFlowStatelessNodeScope StatelessNodeScope(this, Node);
+		AddActiveNode(Node);
+
+		if (Signal.InputPinIndex != INDEX_NONE)
+		{
+			Node->TriggerInputByIndex(Signal.InputPinIndex);
+		}
+		else
+		{
+			Node->TriggerInput(Signal.InputPinName);
+		}
+	}
+}
+
+void UFlowAsset::DrainSignalQueue()
+{
+	if (bDrainingSignals)
+	{
+		return;
+	}
+
+	TGuardValue<bool> DrainingGuard(bDrainingSignals, true);
+	UFlowSubsystem* FlowSubsystem = GetFlowSubsystem();
+
+	while (SignalQueue.Num() > 0)
+	{
+		if (FlowSubsystem && !FlowSubsystem->ConsumeSignalBudget())
+		{
+			FlowSubsystem->DeferSignalQueue(this);
+			return;
+		}
+
+		// signal deferred by the limiter would be popped again in this frame
+		if (FlowSubsystem && SignalLimiter.Policy == EFlowSignalLimitPolicy::Defer && SignalLimiter.HasExceededLimitInFrame())
+		{
+			FlowSubsystem->DeferSignalQueue(this);
+			return;
+		}
+
+		const FFlowCompiledConnection Signal = SignalQueue.Pop(false);
+		const int32 FirstNewSignal = SignalQueue.Num();
+
+		ExecuteSignal(Signal);
+
+		// signals triggered by this node should be processed first and in the order of triggering, as it would happen with recursive calls
+		if (SignalQueue.Num() - FirstNewSignal > 1)
+		{
+			Algo::Reverse(SignalQueue.GetData() + FirstNewSignal, SignalQueue.Num() - FirstNewSignal);
+		}
+	}
+}
+
+bool UFlowAsset::CheckSignalLimits(const FFlowCompiledConnection& Signal)
+{
+	if (bAbortedBySignalLimit)
+	{
+		return false;
+	}
+
+	bool bDepthExceeded = false;
+	if (SignalLimiter.IsEnabled() && !SignalLimiter.TryAddSignal(Signal, bDepthExceeded))
+	{
+		OnSignalLimitExceeded(Signal, bDepthExceeded);
+		return false;
+	}
+
+	return true;
+}
+
+void UFlowAsset::OnSignalLimitExceeded(const FFlowCompiledConnection& Signal, const bool bDepthExceeded)
+{
+	// report only the first signal exceeding the limit in a frame, loop would flood the log otherwise
+	const bool bFirstInFrame = SignalLimiter.MarkLimitExceeded();
+	if (bFirstInFrame || SignalLimiter.Policy == EFlowSignalLimitPolicy::Abort)
+	{
+		TArray<FFlowCompiledConnection> Loop;
+		SignalLimiter.FindLoop(Signal, Loop);
+
+		TArray<FString> LoopDescription;
+		LoopDescription.Reserve(Loop.Num() + 1);
+		for (const FFlowCompiledConnection& LoopSignal : Loop)
+		{
+			LoopDescription.Emplace(DescribeSignal(LoopSignal));
+		}
+		LoopDescription.Emplace(DescribeSignal(Signal));
+
+		const FString Message = FString::Printf(TEXT("%s exceeded %s limit at %s. Recent signals: %s"), *GetName(),
+			bDepthExceeded ? TEXT("the signal depth") : TEXT("the signals per frame"), *DescribeSignal(Signal), *FString::Join(LoopDescription, TEXT(" -> ")));
+
+		if (SignalLimiter.Policy == EFlowSignalLimitPolicy::Defer)
+		{
+			UE_LOG(LogFlow, Warning, TEXT("%s"), *Message);
+		}
+		else
+		{
+			UE_LOG(LogFlow, Error, TEXT("%s"), *Message);
+		}
+	}
+
+	switch (SignalLimiter.Policy)
+	{
+		case EFlowSignalLimitPolicy::Defer:
+			if (UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
+			{
+				// goes after signals queued earlier, the same as signal triggered by latent node
+				SignalQueue.Insert(Signal, 0);
+				FlowSubsystem->DeferSignalQueue(this);
+			}
+			break;
+		case EFlowSignalLimitPolicy::Abort:
+			// instance isn't removed, as the signal loop is still on the call stack
+			bAbortedBySignalLimit = true;
+			FinishFlow(EFlowFinishPolicy::Abort, false);
+			if (UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
+			{
+				FlowSubsystem->DeferAbortedInstance(this);
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+FString UFlowAsset::DescribeSignal(const FFlowCompiledConnection& Signal) const
+{
+	const UFlowNode* Node = GetNodeByIndex(Signal.NodeIndex);
+	FName PinName = Signal.InputPinName;
+
+	if (CompiledGraph.IsValid() && CompiledGraph->IsValidNodeIndex(Signal.NodeIndex) && Signal.InputPinIndex != INDEX_NONE)
+	{
+		PinName = CompiledGraph->InputPinNames[CompiledGraph->Nodes[Signal.NodeIndex].FirstInputPin + Signal.InputPinIndex];
+	}
+
+	return FString::Printf(TEXT("%s.%s"), Node ? *Node->GetName() : *FString::FromInt(Signal.NodeIndex), *PinName.ToString());
+}
+
+void UFlowAsset::AddActiveNode(UFlowNode* Node)
+{
+	if (!ContainsNode(ActiveNodeBits, ActiveNodes, Node))
+	{
+		SetActiveNodeSlot(Node, ActiveNodes.Add(Node));
+		SetNodeBit(ActiveNodeBits, Node, true);
+		FLOW_INC_GAUGE(ActiveNodes, 1);
+
+		RecordNode(Node);
+		UpdatePreloadWindow();
+
+		if (Node->bPreloaded && GetFlowSubsystem())
+		{
+			GetFlowSubsystem()->TouchPreloadedNode(Node);
+		}
+	}
+}
+
+void UFlowAsset::RecordNode(UFlowNode* Node)
+{
+	if (!ContainsNode(RecordedNodeBits, RecordedNodes, Node))
+	{
+		RecordedNodes.Add(Node);
+		SetNodeBit(RecordedNodeBits, Node, true);
+	}
+}
+
+bool UFlowAsset::ContainsNode(const TBitArray<>& NodeBits, const TArray<UFlowNode*>& NodeList, const UFlowNode* Node) const
+{
+	if (NodeBits.IsValidIndex(Node->CompiledIndex) && IndexedNodes[Node->CompiledIndex] == Node)
+	{
+		return NodeBits[Node->CompiledIndex];
+	}
+
+	return NodeList.Contains(Node);
+}
+
+void UFlowAsset::SetNodeBit(TBitArray<>& NodeBits, const UFlowNode* Node, const bool bValue) const
+{
+	if (NodeBits.IsValidIndex(Node->CompiledIndex) && IndexedNodes[Node->CompiledIndex] == Node)
+	{
+		NodeBits[Node->CompiledIndex] = bValue;
+	}
+}
+
+void UFlowAsset::SetActiveNodeSlot(const UFlowNode* Node, const int32 Slot)
+{
+	if (ActiveNodeSlots.IsValidIndex(Node->CompiledIndex) && IndexedNodes[Node->CompiledIndex] == Node)
+	{
+		ActiveNodeSlots[Node->CompiledIndex] = Slot;
+	}
+}
+
+void UFlowAsset::RemoveActiveNode(UFlowNode* Node)
+{
+	const bool bIndexed = ActiveNodeSlots.IsValidIndex(Node->CompiledIndex) && IndexedNodes[Node->CompiledIndex] == Node;
+	const int32 Slot = bIndexed ? ActiveNodeSlots[Node->CompiledIndex] : ActiveNodes.IndexOfByKey(Node);
+	if (!ActiveNodes.IsValidIndex(Slot))
+	{
+		return;
+	}
+
+	ActiveNodes.RemoveAtSwap(Slot, 1, false);
+	SetActiveNodeSlot(Node, INDEX_NONE);
+
+	// the last node took the freed slot
+	if (ActiveNodes.IsValidIndex(Slot))
+	{
+		SetActiveNodeSlot(ActiveNodes[Slot], Slot);
 	}
 }
 
 void UFlowAsset::FinishNode(UFlowNode* Node)
 {
-	if (ActiveNodes.Contains(Node))
+	if (ContainsNode(ActiveNodeBits, ActiveNodes, Node))
 	{
-		ActiveNodes.Remove(Node);
+		RemoveActiveNode(Node);
+		SetNodeBit(ActiveNodeBits, Node, false);
+		FLOW_DEC_GAUGE(ActiveNodes, 1);
+
+		UpdatePreloadWindow();
 
 		// if graph reached Finish and this asset instance was created by SubGraph node
 		if (Node->CanFinishGraph())
@@ -788,10 +1413,15 @@ void UFlowAsset::ResetNodes()
 {
 	for (UFlowNode* Node : RecordedNodes)
 	{
-		Node->ResetRecords();
+		if (!IsSharedNode(Node))
+		{
+			Node->ResetRecords();
+		}
 	}
 
 	RecordedNodes.Empty();
+	RecordedNodeBits.Init(false, IndexedNodes.Num());
+	StatelessNodeStates.Empty();
 }
 
 UFlowSubsystem* UFlowAsset::GetFlowSubsystem() const
@@ -816,6 +1446,8 @@ UFlowAsset* UFlowAsset::GetParentInstance() const
 
 FFlowAssetSaveData UFlowAsset::SaveInstance(TArray<FFlowAssetSaveData>& SavedFlowInstances)
 {
+	FLOW_TRACE_ASSET_SCOPE("SaveInstance", this);
+
 	FFlowAssetSaveData AssetRecord;
 	AssetRecord.WorldName = IsBoundToWorld() ? GetWorld()->GetName() : FString();
 	AssetRecord.InstanceName = GetName();
@@ -828,6 +1460,9 @@ FFlowAssetSaveData UFlowAsset::SaveInstance(TArray<FFlowAssetSaveData>& SavedFlo
 	GetNodesInExecutionOrder<UFlowNode>(GetDefaultEntryNode(), NodesInExecutionOrder);
 	for (UFlowNode* Node : NodesInExecutionOrder)
 	{
+		// shared template node keeps the state of this instance in the side table
+		FFlowStatelessNodeScope StatelessNodeScope(this, Node);
+
 		if (Node && Node->ActivationState == EFlowNodeState::Active)
 		{
 			// iterate SubGraphs
@@ -861,6 +1496,9 @@ FFlowAssetSaveData UFlowAsset::SaveInstance(TArray<FFlowAssetSaveData>& SavedFlo
 
 void UFlowAsset::LoadInstance(const FFlowAssetSaveData& AssetRecord)
 {
+	FLOW_TRACE_ASSET_SCOPE("LoadInstance", this);
+	FLOW_SCOPE_TIMING(LoadInstance);
+
 	FMemoryReader MemoryReader(AssetRecord.AssetData, true);
 	FFlowArchive Ar(MemoryReader);
 	Serialize(Ar);
@@ -871,8 +1509,10 @@ void UFlowAsset::LoadInstance(const FFlowAssetSaveData& AssetRecord)
 	// prevents issue when the preceding node would instantly fire output to a not-yet-loaded node
 	for (int32 i = AssetRecord.NodeRecords.Num() - 1; i >= 0; i--)
 	{
-		if (UFlowNode* Node = Nodes.FindRef(AssetRecord.NodeRecords[i].NodeGuid))
+		if (UFlowNode* Node = GetNodeInstance(AssetRecord.NodeRecords[i].NodeGuid))
 		{
+			// loaded state of the shared template node goes to the side table of this instance
+			FFlowStatelessNodeScope StatelessNodeScope(this, Node);
 			Node->LoadInstance(AssetRecord.NodeRecords[i]);
 		}
 	}
@@ -884,12 +1524,12 @@ void UFlowAsset::OnActivationStateLoaded(UFlowNode* Node)
 {
 	if (Node->ActivationState != EFlowNodeState::NeverActivated)
 	{
-		RecordedNodes.Emplace(Node);
+		RecordNode(Node);
 	}
 
 	if (Node->ActivationState == EFlowNodeState::Active)
 	{
-		ActiveNodes.Emplace(Node);
+		AddActiveNode(Node);
 	}
 }
 
@@ -24,6 +24,7 @@ UFlowComponent::UFlowComponent(const FObjectInitializer& ObjectInitializer)
 	, bAutoStartRootFlow(true)
 	, RootFlowMode(EFlowNetMode::Authority)
 	, bAllowMultipleInstances(true)
+	, RootFlowPriority(0)
 {
 	PrimaryComponentTick.bCanEverTick = false;
 	PrimaryComponentTick.bStartWithTickEnabled = false;
@@ -459,10 +460,10 @@ UFlowAsset* UFlowComponent::GetRootFlowInstance() const
 {
 	if (const UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
 	{
-		const TSet<UFlowAsset*> Result = FlowSubsystem->GetRootInstancesByOwner(this);
+		const TConstArrayView<UFlowAsset*> Result = FlowSubsystem->FindRootInstancesByOwner(this);
 		if (Result.Num() > 0)
 		{
-			return Result.Array()[0];
+			return Result[0];
 		}
 	}
 
@@ -1,15 +1,31 @@
 // Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
 
 #include "FlowModule.h"
+#include "FlowProfiling.h"
+#include "Types/FlowTrace.h"
 
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/Parse.h"
 #include "Modules/ModuleManager.h"
 
 void FFlowModule::StartupModule()
 {
+	// allows tracing cooked builds from the launch
+	if (FParse::Param(FCommandLine::Get(), TEXT("FlowTrace")))
+	{
+		FFlowTraceRecorder::Get().Start(FFlowTraceRecorder::DefaultCapacity, FFlowTraceRecorder::GetDefaultFilename());
+	}
+
+#if CSV_PROFILER
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&FlowProfiling::PublishGauges);
+#endif
 }
 
 void FFlowModule::ShutdownModule()
 {
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	FFlowTraceRecorder::Get().Stop();
 }
 
 IMPLEMENT_MODULE(FFlowModule, Flow)
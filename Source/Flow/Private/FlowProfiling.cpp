@@ -0,0 +1,51 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowProfiling.h"
+#include "FlowAsset.h"
+#include "Nodes/FlowNode.h"
+
+UE_TRACE_CHANNEL_DEFINE(FlowChannel);
+
+DEFINE_STAT(STAT_FlowInstancedTemplates);
+DEFINE_STAT(STAT_FlowLiveInstances);
+DEFINE_STAT(STAT_FlowActiveNodes);
+DEFINE_STAT(STAT_FlowRegisteredComponents);
+
+DEFINE_STAT(STAT_FlowSignals);
+DEFINE_STAT(STAT_FlowInstancesCreated);
+DEFINE_STAT(STAT_FlowInstancesDestroyed);
+DEFINE_STAT(STAT_FlowRegistryQueries);
+
+DEFINE_STAT(STAT_FlowSaveGame);
+DEFINE_STAT(STAT_FlowLoadInstance);
+
+CSV_DEFINE_CATEGORY_MODULE(FLOW_API, Flow, true);
+
+namespace FlowProfiling
+{
+	// instances are named after templates with a suffix, template name identifies the graph
+	static FString GetTemplateName(const UFlowAsset* FlowAsset)
+	{
+		return GetNameSafe(FlowAsset && FlowAsset->GetTemplateAsset() ? FlowAsset->GetTemplateAsset() : FlowAsset);
+	}
+
+	FString GetNodeEventName(const TCHAR* Name, const UFlowNode* Node)
+	{
+		return FString::Printf(TEXT("%s %s (%s)"), Name, *GetNameSafe(Node ? Node->GetClass() : nullptr), *GetTemplateName(Node ? Node->GetFlowAsset() : nullptr));
+	}
+
+	FString GetAssetEventName(const TCHAR* Name, const UFlowAsset* FlowAsset)
+	{
+		return FString::Printf(TEXT("%s %s"), Name, *GetTemplateName(FlowAsset));
+	}
+
+	FGauges Gauges;
+
+	void PublishGauges()
+	{
+		CSV_CUSTOM_STAT(Flow, InstancedTemplates, Gauges.InstancedTemplates, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(Flow, LiveInstances, Gauges.LiveInstances, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(Flow, ActiveNodes, Gauges.ActiveNodes, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(Flow, RegisteredComponents, Gauges.RegisteredComponents, ECsvCustomStatOp::Set);
+	}
+}
@@ -11,6 +11,16 @@ UFlowSettings::UFlowSettings(const FObjectInitializer& ObjectInitializer)
 	, bWarnAboutMissingIdentityTags(true)
 	, bLogOnSignalDisabled(true)
 	, bLogOnSignalPassthrough(true)
+	, bQueueSignals(false)
+	, MaxSignalsPerFrame(0)
+	, FrameBudgetMs(0.0f)
+	, MaxSignalDepth(0)
+	, MaxInstanceSignalsPerFrame(0)
+	, SignalLimitPolicy(EFlowSignalLimitPolicy::Log)
+	, bShareStatelessNodes(false)
+	, bOptimizeCompiledGraph(false)
+	, bAsyncSubGraphs(false)
+	, PreloadBudgetMB(0)
 	, bUseAdaptiveNodeTitles(false)
 	, DefaultExpectedOwnerClass(UFlowComponent::StaticClass())
 {
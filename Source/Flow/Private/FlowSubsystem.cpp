@@ -5,6 +5,7 @@
 #include "FlowAsset.h"
 #include "FlowComponent.h"
 #include "FlowLogChannels.h"
+#include "FlowProfiling.h"
 #include "FlowSave.h"
 #include "FlowSettings.h"
 #include "Nodes/Route/FlowNode_SubGraph.h"
@@ -26,6 +27,14 @@ FNativeFlowAssetEvent UFlowSubsystem::OnInstancedTemplateRemoved;
 
 UFlowSubsystem::UFlowSubsystem()
 	: LoadedSaveGame(nullptr)
+	, bTearingDown(false)
+	, SignalBudgetFrame(0)
+	, SignalsInCurrentFrame(0)
+	, TimeBudgetFrame(0)
+	, TimeSpentInCurrentFrame(0.0)
+	, BudgetedWorkStartTime(0.0)
+	, BudgetedWorkDepth(0)
+	, NextAsyncRequestId(0)
 {
 }
 
@@ -55,258 +64,1218 @@ void UFlowSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 void UFlowSubsystem::Deinitialize()
 {
 	AbortActiveFlows();
+
+	if (SchedulerTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(SchedulerTickerHandle);
+		SchedulerTickerHandle.Reset();
+	}
+	DeferredSignalInstances.Empty();
+	AbortedInstances.Empty();
+}
+
+void UFlowSubsystem::AbortActiveFlows()
+{
+	// finishing instances skips per-instance bookkeeping, containers are emptied in bulk below
+	TGuardValue<bool> TearingDownGuard(bTearingDown, true);
+
+	// instances are still finished one by one, but the subsystem removes each template once instead of tracking every finished instance
+	// nodes might instance another template while finishing, it's cleared in the next pass
+	static constexpr int32 MaxPasses = 8;
+	for (int32 Pass = 0; Pass < MaxPasses && InstancedTemplates.Num() > 0; Pass++)
+	{
+		TArray<UFlowAsset*> Templates;
+		InstancedTemplates.GetKeys(Templates);
+
+		for (int32 i = Templates.Num() - 1; i >= 0; i--)
+		{
+			if (Templates[i])
+			{
+				Templates[i]->ClearInstances();
+			}
+		}
+
+		for (UFlowAsset* Template : Templates)
+		{
+			if (Template)
+			{
+				RemoveInstancedTemplate(Template);
+			}
+		}
+	}
+
+	RemoveTornDownBindings();
+	VerifyTeardown();
+
+	for (const TPair<UFlowAsset*, FFlowInstancedTemplateStats>& InstancedTemplate : InstancedTemplates)
+	{
+		if (UFlowAsset* Template = InstancedTemplate.Key)
+		{
+			FLOW_DEC_GAUGE(LiveInstances, Template->ActiveInstances.Num());
+			Template->ActiveInstances.Empty();
+		}
+	}
+
+	FLOW_DEC_GAUGE(InstancedTemplates, InstancedTemplates.Num());
+	InstancedTemplates.Empty();
+	InstancedSubFlows.Empty();
+
+	RootInstances.Empty();
+	RootInstancesByOwner.Empty();
+	RootInstancesByOwnerAndTemplate.Empty();
+	PendingRootFlows.Empty();
+	CancelAsyncRootFlows(nullptr);
+	CancelAsyncSubFlow(nullptr);
+
+	PreloadEntries.Empty();
+	PreloadStats.PreloadedNodes = 0;
+	PreloadStats.EstimatedBytes = 0;
+
+	EmptyInstancePools();
+}
+
+template <typename DelegateType>
+static void RemoveBindingsOfInstances(DelegateType& Delegate, const UObject* FlowSubsystem)
+{
+	const TArray<UObject*> BoundObjects = Delegate.GetAllObjects();
+	const bool bOnlyInstancesBound = !BoundObjects.ContainsByPredicate([FlowSubsystem](const UObject* Object)
+	{
+		return Object && !Object->IsIn(FlowSubsystem);
+	});
+
+	// usually only nodes are bound, so the whole invocation list goes at once
+	if (bOnlyInstancesBound)
+	{
+		Delegate.Clear();
+		return;
+	}
+
+	for (UObject* Object : BoundObjects)
+	{
+		if (Object && Object->IsIn(FlowSubsystem))
+		{
+			Delegate.RemoveAll(Object);
+		}
+	}
+}
+
+void UFlowSubsystem::RemoveTornDownBindings()
+{
+	// Flow Asset instances are outered to the subsystem, and so are their nodes
+	RemoveBindingsOfInstances(OnComponentRegistered, this);
+	RemoveBindingsOfInstances(OnComponentUnregistered, this);
+	RemoveBindingsOfInstances(OnComponentTagAdded, this);
+	RemoveBindingsOfInstances(OnComponentTagRemoved, this);
+}
+
+void UFlowSubsystem::VerifyTeardown() const
+{
+#if !UE_BUILD_SHIPPING
+	// templates kept being instanced by nodes finishing in every pass, these instances are dropped without finishing
+	for (const TPair<UFlowAsset*, FFlowInstancedTemplateStats>& InstancedTemplate : InstancedTemplates)
+	{
+		UE_LOG(LogFlow, Error, TEXT("%s still has %d instances after aborting active flows."), *GetNameSafe(InstancedTemplate.Key),
+			InstancedTemplate.Key ? InstancedTemplate.Key->GetInstancesNum() : 0);
+	}
+
+	int32 NumLeakedBindings = 0;
+	auto CountLeakedBindings = [this, &NumLeakedBindings](const TArray<UObject*>& BoundObjects)
+	{
+		for (const UObject* Object : BoundObjects)
+		{
+			if (Object && Object->IsIn(this))
+			{
+				NumLeakedBindings++;
+			}
+		}
+	};
+	CountLeakedBindings(OnComponentRegistered.GetAllObjects());
+	CountLeakedBindings(OnComponentUnregistered.GetAllObjects());
+	CountLeakedBindings(OnComponentTagAdded.GetAllObjects());
+	CountLeakedBindings(OnComponentTagRemoved.GetAllObjects());
+
+	if (NumLeakedBindings > 0)
+	{
+		UE_LOG(LogFlow, Error, TEXT("%d Flow Subsystem delegates are still bound to Flow nodes after aborting active flows."), NumLeakedBindings);
+	}
+#endif
+}
+
+void UFlowSubsystem::StartRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const bool bAllowMultipleInstances /* = true */)
+{
+	if (FlowAsset)
+	{
+		if (PendingRootFlows.Num() > 0 || IsFrameBudgetExceeded())
+		{
+			QueueRootFlow(Owner, FlowAsset, bAllowMultipleInstances);
+			return;
+		}
+
+		BeginBudgetedWork();
+		if (UFlowAsset* NewFlow = CreateRootFlow(Owner, FlowAsset, bAllowMultipleInstances))
+		{
+			NewFlow->StartFlow();
+		}
+		EndBudgetedWork();
+	}
+#if WITH_EDITOR
+	else
+	{
+		FMessageLog("PIE").Error(LOCTEXT("StartRootFlowNullAsset", "Attempted to start Root Flow with a null asset."))
+		                  ->AddToken(FUObjectToken::Create(Owner));
+	}
+#endif
+}
+
+UFlowAsset* UFlowSubsystem::CreateRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const bool bAllowMultipleInstances)
+{
+	if (FindRootInstance(Owner, FlowAsset))
+	{
+		UE_LOG(LogFlow, Warning, TEXT("Attempted to start Root Flow for the same Owner again. Owner: %s. Flow Asset: %s."), *GetNameSafe(Owner), *FlowAsset->GetName());
+		return nullptr;
+	}
+
+	if (!bAllowMultipleInstances && InstancedTemplates.Contains(FlowAsset))
+	{
+		UE_LOG(LogFlow, Warning, TEXT("Attempted to start Root Flow, although there can be only a single instance. Owner: %s. Flow Asset: %s."), *Owner->GetName(), *FlowAsset->GetName());
+		return nullptr;
+	}
+
+	UFlowAsset* NewFlow = CreateFlowInstance(Owner, FlowAsset);
+	if (NewFlow)
+	{
+		AddRootInstance(Owner, NewFlow);
+	}
+
+	return NewFlow;
+}
+
+void UFlowSubsystem::FinishRootFlow(UObject* Owner, UFlowAsset* TemplateAsset, const EFlowFinishPolicy FinishPolicy)
+{
+	RemovePendingRootFlows(Owner, TemplateAsset);
+
+	UFlowAsset* InstanceToFinish = Owner ? FindRootInstance(Owner, TemplateAsset) : nullptr;
+	if (InstanceToFinish)
+	{
+		RemoveRootInstance(Owner, InstanceToFinish);
+		InstanceToFinish->FinishFlow(FinishPolicy);
+	}
+}
+
+void UFlowSubsystem::FinishAllRootFlows(UObject* Owner, const EFlowFinishPolicy FinishPolicy)
+{
+	RemovePendingRootFlows(Owner);
+
+	if (Owner == nullptr)
+	{
+		return;
+	}
+
+	// finishing flow might start or finish other root flows of this owner
+	const TArray<UFlowAsset*, TInlineAllocator<1>> InstancesToFinish(FindRootInstancesByOwner(Owner));
+
+	for (UFlowAsset* InstanceToFinish : InstancesToFinish)
+	{
+		RemoveRootInstance(Owner, InstanceToFinish);
+		InstanceToFinish->FinishFlow(FinishPolicy);
+	}
+}
+
+void UFlowSubsystem::AddRootInstance(UObject* Owner, UFlowAsset* Instance)
+{
+	RootInstances.Add(Instance, Owner);
+	RootInstancesByOwner.FindOrAdd(FObjectKey(Owner)).Add(Instance);
+	RootInstancesByOwnerAndTemplate.Add(MakeTuple(FObjectKey(Owner), FObjectKey(Instance->GetTemplateAsset())), Instance);
+}
+
+void UFlowSubsystem::RemoveRootInstance(const UObject* Owner, UFlowAsset* Instance)
+{
+	RootInstances.Remove(Instance);
+	RootInstancesByOwnerAndTemplate.Remove(MakeTuple(FObjectKey(Owner), FObjectKey(Instance->GetTemplateAsset())));
+
+	const FObjectKey OwnerKey(Owner);
+	if (TArray<UFlowAsset*, TInlineAllocator<1>>* OwnedInstances = RootInstancesByOwner.Find(OwnerKey))
+	{
+		OwnedInstances->RemoveSingle(Instance);
+		if (OwnedInstances->Num() == 0)
+		{
+			RootInstancesByOwner.Remove(OwnerKey);
+		}
+	}
 }
 
-void UFlowSubsystem::AbortActiveFlows()
-{
-	if (InstancedTemplates.Num() > 0)
+void UFlowSubsystem::UnregisterRootInstance(UFlowAsset* Instance)
+{
+	const TWeakObjectPtr<UObject>* Owner = RootInstances.Find(Instance);
+	if (Owner == nullptr)
+	{
+		return;
+	}
+
+	if (Owner->IsValid())
+	{
+		RemoveRootInstance(Owner->Get(), Instance);
+		return;
+	}
+
+	// owner has been destroyed, so its key is found through the instance
+	RootInstances.Remove(Instance);
+	for (auto It = RootInstancesByOwner.CreateIterator(); It; ++It)
+	{
+		if (It->Value.RemoveSingle(Instance) > 0)
+		{
+			RootInstancesByOwnerAndTemplate.Remove(MakeTuple(It->Key, FObjectKey(Instance->GetTemplateAsset())));
+			if (It->Value.Num() == 0)
+			{
+				It.RemoveCurrent();
+			}
+			break;
+		}
+	}
+}
+
+UFlowAsset* UFlowSubsystem::CreateSubFlow(UFlowNode_SubGraph* SubGraphNode, const FString SavedInstanceName, const bool bPreloading /* = false */)
+{
+	// SubGraph restored from the SaveGame has to be instanced immediately, so its state can be loaded
+	if (UFlowSettings::Get()->bAsyncSubGraphs && SavedInstanceName.IsEmpty() && !InstancedSubFlows.Contains(SubGraphNode))
+	{
+		if (FFlowAsyncSubFlow* AsyncSubFlow = FindAsyncSubFlow(SubGraphNode))
+		{
+			if (!bPreloading && !AsyncSubFlow->bStartRequested)
+			{
+				AsyncSubFlow->bStartRequested = true;
+				SchedulerStats.DeferredSubFlowStarts++;
+			}
+			return nullptr;
+		}
+
+		// resident asset can be started right away, but preloading never blocks the game thread
+		if (bPreloading || SubGraphNode->Asset.Get() == nullptr)
+		{
+			RequestAsyncSubFlow(SubGraphNode, !bPreloading);
+			return nullptr;
+		}
+	}
+
+	return InstantiateSubFlow(SubGraphNode, SavedInstanceName, bPreloading);
+}
+
+UFlowAsset* UFlowSubsystem::InstantiateSubFlow(UFlowNode_SubGraph* SubGraphNode, const FString& SavedInstanceName, const bool bPreloading)
+{
+	UFlowAsset* NewInstance = nullptr;
+
+	if (!InstancedSubFlows.Contains(SubGraphNode))
+	{
+		const TWeakObjectPtr<UObject> Owner = SubGraphNode->GetFlowAsset() ? SubGraphNode->GetFlowAsset()->GetOwner() : nullptr;
+		NewInstance = CreateFlowInstance(Owner, SubGraphNode->Asset, SavedInstanceName);
+
+		if (NewInstance)
+		{
+			InstancedSubFlows.Add(SubGraphNode, NewInstance);
+
+			if (bPreloading)
+			{
+				NewInstance->PreloadNodes();
+			}
+		}
+	}
+
+	if (InstancedSubFlows.Contains(SubGraphNode) && !bPreloading)
+	{
+		// get instanced asset from map - in case it was already instanced by calling CreateSubFlow() with bPreloading == true
+		UFlowAsset* AssetInstance = InstancedSubFlows[SubGraphNode];
+
+		AssetInstance->NodeOwningThisAssetInstance = SubGraphNode;
+		SubGraphNode->GetFlowAsset()->ActiveSubGraphs.Add(SubGraphNode, AssetInstance);
+
+		// don't activate Start Node if we're loading Sub Graph from SaveGame
+		if (SavedInstanceName.IsEmpty())
+		{
+			AssetInstance->StartFlow();
+		}
+	}
+
+	return NewInstance;
+}
+
+void UFlowSubsystem::RemoveSubFlow(UFlowNode_SubGraph* SubGraphNode, const EFlowFinishPolicy FinishPolicy)
+{
+	// teardown cancels all pending loads at once
+	if (!bTearingDown)
+	{
+		CancelAsyncSubFlow(SubGraphNode);
+	}
+
+	if (InstancedSubFlows.Contains(SubGraphNode))
+	{
+		UFlowAsset* AssetInstance = InstancedSubFlows[SubGraphNode];
+		AssetInstance->NodeOwningThisAssetInstance = nullptr;
+
+		SubGraphNode->GetFlowAsset()->ActiveSubGraphs.Remove(SubGraphNode);
+		InstancedSubFlows.Remove(SubGraphNode);
+
+		AssetInstance->FinishFlow(FinishPolicy);
+	}
+}
+
+UFlowAsset* UFlowSubsystem::CreateFlowInstance(const TWeakObjectPtr<UObject> Owner, TSoftObjectPtr<UFlowAsset> FlowAsset, FString NewInstanceName)
+{
+	UFlowAsset* LoadedFlowAsset = FlowAsset.LoadSynchronous();
+	if (LoadedFlowAsset == nullptr)
+	{
+		return nullptr;
+	}
+
+	FLOW_TRACE_ASSET_SCOPE("CreateFlowInstance", LoadedFlowAsset);
+
+	AddInstancedTemplate(LoadedFlowAsset);
+
+#if WITH_EDITOR
+	if (GetWorld()->WorldType != EWorldType::Game)
+	{
+		// Fix connections - even in packaged game if assets haven't been re-saved in the editor after changing node's definition
+		LoadedFlowAsset->HarvestNodeConnections();
+	}
+#endif
+
+	if (LoadedFlowAsset->InstancePoolSize > 0 && !InstancePools.Contains(LoadedFlowAsset))
+	{
+		WarmupInstancePool(LoadedFlowAsset, LoadedFlowAsset->InstancePoolWarmup);
+	}
+
+	// instance restored from the SaveGame has to use the saved name, so it can't be taken from the pool
+	UFlowAsset* NewInstance = NewInstanceName.IsEmpty() ? AcquirePooledInstance(LoadedFlowAsset) : nullptr;
+	if (NewInstance)
+	{
+		NewInstance->ReinitializeInstance(Owner);
+	}
+	else
+	{
+		// it won't be empty, if we're restoring Flow Asset instance from the SaveGame
+		if (NewInstanceName.IsEmpty())
+		{
+			NewInstanceName = MakeUniqueObjectName(this, UFlowAsset::StaticClass(), *FPaths::GetBaseFilename(LoadedFlowAsset->GetPathName())).ToString();
+		}
+		else
+		{
+			EvictPooledInstance(NewInstanceName);
+		}
+
+		NewInstance = NewObject<UFlowAsset>(this, LoadedFlowAsset->GetClass(), *NewInstanceName, RF_Transient, LoadedFlowAsset, false, nullptr);
+		NewInstance->InitializeInstance(Owner, LoadedFlowAsset);
+	}
+
+	LoadedFlowAsset->AddInstance(NewInstance);
+	if (FFlowInstancedTemplateStats* TemplateStats = InstancedTemplates.Find(LoadedFlowAsset))
+	{
+		TemplateStats->OnInstanceAdded(LoadedFlowAsset->GetInstancesNum());
+	}
+	FLOW_INC_COUNTER(InstancesCreated);
+
+	return NewInstance;
+}
+
+void UFlowSubsystem::AddInstancedTemplate(UFlowAsset* Template)
+{
+	if (!InstancedTemplates.Contains(Template))
+	{
+		InstancedTemplates.Add(Template, FFlowInstancedTemplateStats());
+		FLOW_INC_GAUGE(InstancedTemplates, 1);
+
+#if WITH_EDITOR
+		Template->RuntimeLog = MakeShareable(new FFlowMessageLog());
+		OnInstancedTemplateAdded.ExecuteIfBound(Template);
+#endif
+	}
+}
+
+void UFlowSubsystem::RemoveInstancedTemplate(UFlowAsset* Template)
+{
+#if WITH_EDITOR
+	OnInstancedTemplateRemoved.ExecuteIfBound(Template);
+	Template->RuntimeLog.Reset();
+#endif
+
+	if (InstancedTemplates.Remove(Template) > 0)
+	{
+		FLOW_DEC_GAUGE(InstancedTemplates, 1);
+	}
+}
+
+void UFlowSubsystem::OnInstanceRemoved(UFlowAsset* Template, const int32 InstancesLeft)
+{
+	if (InstancesLeft == 0)
+	{
+		RemoveInstancedTemplate(Template);
+	}
+	else if (FFlowInstancedTemplateStats* TemplateStats = InstancedTemplates.Find(Template))
+	{
+		TemplateStats->ActiveInstances = InstancesLeft;
+	}
+}
+
+FFlowInstancedTemplateStats UFlowSubsystem::GetInstancedTemplateStats(const UFlowAsset* Template /* = nullptr */) const
+{
+	if (Template)
+	{
+		return InstancedTemplates.FindRef(Template);
+	}
+
+	FFlowInstancedTemplateStats Result;
+	for (const TPair<UFlowAsset*, FFlowInstancedTemplateStats>& InstancedTemplate : InstancedTemplates)
+	{
+		Result += InstancedTemplate.Value;
+	}
+	return Result;
+}
+
+TMap<UObject*, UFlowAsset*> UFlowSubsystem::GetRootInstances() const
+{
+	TMap<UObject*, UFlowAsset*> Result;
+	for (const TPair<UFlowAsset*, TWeakObjectPtr<UObject>>& RootInstance : RootInstances)
+	{
+		Result.Emplace(RootInstance.Value.Get(), RootInstance.Key);
+	}
+	return Result;
+}
+
+TSet<UFlowAsset*> UFlowSubsystem::GetRootInstancesByOwner(const UObject* Owner) const
+{
+	TSet<UFlowAsset*> Result;
+	Result.Append(FindRootInstancesByOwner(Owner));
+	return Result;
+}
+
+UFlowAsset* UFlowSubsystem::GetRootFlow(const UObject* Owner) const
+{
+	const TConstArrayView<UFlowAsset*> Result = FindRootInstancesByOwner(Owner);
+	return Result.Num() > 0 ? Result[0] : nullptr;
+}
+
+TConstArrayView<UFlowAsset*> UFlowSubsystem::FindRootInstancesByOwner(const UObject* Owner) const
+{
+	if (Owner)
+	{
+		if (const TArray<UFlowAsset*, TInlineAllocator<1>>* OwnedInstances = RootInstancesByOwner.Find(FObjectKey(Owner)))
+		{
+			return *OwnedInstances;
+		}
+	}
+
+	return TConstArrayView<UFlowAsset*>();
+}
+
+UFlowAsset* UFlowSubsystem::FindRootInstance(const UObject* Owner, const UFlowAsset* TemplateAsset) const
+{
+	return RootInstancesByOwnerAndTemplate.FindRef(MakeTuple(FObjectKey(Owner), FObjectKey(TemplateAsset)));
+}
+
+UWorld* UFlowSubsystem::GetWorld() const
+{
+	return GetGameInstance()->GetWorld();
+}
+
+bool UFlowSubsystem::HasSignalBudget()
+{
+	if (IsFrameBudgetExceeded())
+	{
+		return false;
+	}
+
+	const int32 MaxSignalsPerFrame = UFlowSettings::Get()->MaxSignalsPerFrame;
+	if (MaxSignalsPerFrame <= 0)
+	{
+		return true;
+	}
+
+	if (SignalBudgetFrame != GFrameCounter)
+	{
+		SignalBudgetFrame = GFrameCounter;
+		SignalsInCurrentFrame = 0;
+	}
+
+	return SignalsInCurrentFrame < MaxSignalsPerFrame;
+}
+
+bool UFlowSubsystem::ConsumeSignalBudget()
+{
+	if (!HasSignalBudget())
+	{
+		return false;
+	}
+
+	if (UFlowSettings::Get()->MaxSignalsPerFrame > 0)
+	{
+		SignalsInCurrentFrame++;
+	}
+	return true;
+}
+
+void UFlowSubsystem::DeferSignalQueue(UFlowAsset* FlowInstance)
+{
+	if (!DeferredSignalInstances.Contains(FlowInstance))
+	{
+		DeferredSignalInstances.Add(FlowInstance);
+		SchedulerStats.DeferredSignalQueues++;
+	}
+
+	StartSchedulerTicker();
+}
+
+void UFlowSubsystem::DeferAbortedInstance(UFlowAsset* FlowInstance)
+{
+	AbortedInstances.AddUnique(FlowInstance);
+	StartSchedulerTicker();
+}
+
+bool UFlowSubsystem::IsFrameBudgetExceeded()
+{
+	const float FrameBudgetMs = UFlowSettings::Get()->FrameBudgetMs;
+	if (FrameBudgetMs <= 0.0f)
+	{
+		return false;
+	}
+
+	if (TimeBudgetFrame != GFrameCounter)
+	{
+		return false;
+	}
+
+	double TimeSpent = TimeSpentInCurrentFrame;
+	if (BudgetedWorkDepth > 0)
+	{
+		TimeSpent += FPlatformTime::Seconds() - BudgetedWorkStartTime;
+	}
+
+	return TimeSpent * 1000.0 >= FrameBudgetMs;
+}
+
+void UFlowSubsystem::ResetSchedulerStats()
+{
+	SchedulerStats = FFlowSchedulerStats();
+}
+
+int32 UFlowSubsystem::GetRootFlowPriority(const UObject* Owner, const UFlowAsset* FlowAsset) const
+{
+	int32 Priority = FlowAsset->StartPriority;
+
+	if (const UFlowComponent* FlowComponent = Cast<UFlowComponent>(Owner))
+	{
+		Priority += FlowComponent->RootFlowPriority;
+	}
+
+	return Priority;
+}
+
+FFlowPendingRootFlow* UFlowSubsystem::QueueRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const bool bAllowMultipleInstances)
+{
+	for (const FFlowPendingRootFlow& PendingRootFlow : PendingRootFlows)
+	{
+		if (Owner == PendingRootFlow.Owner.Get() && FlowAsset == PendingRootFlow.FlowAsset.Get())
+		{
+			UE_LOG(LogFlow, Warning, TEXT("Attempted to start Root Flow for the same Owner again, while it's waiting for the frame budget. Owner: %s. Flow Asset: %s."), *GetNameSafe(Owner), *FlowAsset->GetName());
+			return nullptr;
+		}
+	}
+
+	const int32 Priority = GetRootFlowPriority(Owner, FlowAsset);
+
+	// keep order of requests with the same priority
+	int32 InsertIndex = PendingRootFlows.Num();
+	while (InsertIndex > 0 && PendingRootFlows[InsertIndex - 1].Priority < Priority)
+	{
+		InsertIndex--;
+	}
+	PendingRootFlows.Insert(FFlowPendingRootFlow(Owner, FlowAsset, bAllowMultipleInstances, Priority, GFrameCounter), InsertIndex);
+
+	SchedulerStats.DeferredRootFlows++;
+	SchedulerStats.PeakPendingRootFlows = FMath::Max(SchedulerStats.PeakPendingRootFlows, PendingRootFlows.Num());
+
+	StartSchedulerTicker();
+	return &PendingRootFlows[InsertIndex];
+}
+
+void UFlowSubsystem::RemovePendingRootFlows(const UObject* Owner, const UFlowAsset* TemplateAsset /* = nullptr */)
+{
+	if (Owner == nullptr)
+	{
+		return;
+	}
+
+	PendingRootFlows.RemoveAll([Owner, TemplateAsset](const FFlowPendingRootFlow& PendingRootFlow)
+	{
+		return PendingRootFlow.Owner.Get() == Owner && (TemplateAsset == nullptr || PendingRootFlow.FlowAsset.Get() == TemplateAsset);
+	});
+
+	CancelAsyncRootFlows(Owner, TemplateAsset);
+}
+
+void UFlowSubsystem::StartRootFlowAsync(UObject* Owner, TSoftObjectPtr<UFlowAsset> FlowAsset, const FFlowAsyncRootFlowEvent& OnStarted, const bool bAllowMultipleInstances /* = true */)
+{
+	if (FlowAsset.IsNull())
+	{
+#if WITH_EDITOR
+		FMessageLog("PIE").Error(LOCTEXT("StartRootFlowAsyncNullAsset", "Attempted to start Root Flow asynchronously with a null asset."))
+		                  ->AddToken(FUObjectToken::Create(Owner));
+#endif
+		OnStarted.ExecuteIfBound(Owner, nullptr);
+		return;
+	}
+
+	// hard dependencies are already loaded together with the asset
+	if (UFlowAsset* LoadedFlowAsset = FlowAsset.Get())
+	{
+		StartLoadedRootFlow(Owner, LoadedFlowAsset, bAllowMultipleInstances, OnStarted, nullptr);
+		return;
+	}
+
+	for (const FFlowAsyncRootFlow& AsyncRootFlow : AsyncRootFlows)
 	{
-		for (int32 i = InstancedTemplates.Num() - 1; i >= 0; i--)
+		if (Owner == AsyncRootFlow.Owner.Get() && FlowAsset == AsyncRootFlow.FlowAsset)
 		{
-			if (InstancedTemplates.IsValidIndex(i) && InstancedTemplates[i])
-			{
-				InstancedTemplates[i]->ClearInstances();
-			}
+			UE_LOG(LogFlow, Warning, TEXT("Attempted to start Root Flow for the same Owner again, while its asset is being loaded. Owner: %s. Flow Asset: %s."), *GetNameSafe(Owner), *FlowAsset.ToString());
+			OnStarted.ExecuteIfBound(Owner, nullptr);
+			return;
 		}
 	}
 
-	InstancedTemplates.Empty();
-	InstancedSubFlows.Empty();
+	const int32 RequestId = NextAsyncRequestId++;
+	AsyncRootFlows.Add(FFlowAsyncRootFlow(RequestId, Owner, FlowAsset, bAllowMultipleInstances, OnStarted));
 
-	RootInstances.Empty();
+	const TSharedPtr<FStreamableHandle> LoadHandle = StreamableManager.RequestAsyncLoad(FlowAsset.ToSoftObjectPath(), FStreamableDelegate::CreateUObject(this, &UFlowSubsystem::OnRootFlowAssetLoaded, RequestId));
+
+	// completion delegate might have been already called, if loading failed immediately
+	if (FFlowAsyncRootFlow* AsyncRootFlow = AsyncRootFlows.FindByPredicate([RequestId](const FFlowAsyncRootFlow& Request) { return Request.RequestId == RequestId; }))
+	{
+		AsyncRootFlow->LoadHandle = LoadHandle;
+	}
 }
 
-void UFlowSubsystem::StartRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const bool bAllowMultipleInstances /* = true */)
+void UFlowSubsystem::OnRootFlowAssetLoaded(const int32 RequestId)
 {
-	if (FlowAsset)
+	const int32 RequestIndex = AsyncRootFlows.IndexOfByPredicate([RequestId](const FFlowAsyncRootFlow& Request) { return Request.RequestId == RequestId; });
+	if (RequestIndex == INDEX_NONE)
 	{
-		if (UFlowAsset* NewFlow = CreateRootFlow(Owner, FlowAsset, bAllowMultipleInstances))
+		return;
+	}
+
+	const FFlowAsyncRootFlow AsyncRootFlow = AsyncRootFlows[RequestIndex];
+	AsyncRootFlows.RemoveAt(RequestIndex, 1, false);
+
+	UObject* Owner = AsyncRootFlow.Owner.Get();
+	if (Owner == nullptr)
+	{
+		UE_LOG(LogFlow, Verbose, TEXT("Owner has been destroyed while loading Root Flow asset, start cancelled. Flow Asset: %s."), *AsyncRootFlow.FlowAsset.ToString());
+		return;
+	}
+
+	UFlowAsset* LoadedFlowAsset = AsyncRootFlow.FlowAsset.Get();
+	if (LoadedFlowAsset)
+	{
+		SchedulerStats.AsyncLoadedRootFlows++;
+		SchedulerStats.MaxAsyncLoadTimeMs = FMath::Max(SchedulerStats.MaxAsyncLoadTimeMs, static_cast<float>((FPlatformTime::Seconds() - AsyncRootFlow.RequestTime) * 1000.0));
+
+		StartLoadedRootFlow(Owner, LoadedFlowAsset, AsyncRootFlow.bAllowMultipleInstances, AsyncRootFlow.OnStarted, AsyncRootFlow.LoadHandle);
+	}
+	else
+	{
+		UE_LOG(LogFlow, Error, TEXT("Failed to load Root Flow asset. Owner: %s. Flow Asset: %s."), *Owner->GetName(), *AsyncRootFlow.FlowAsset.ToString());
+		AsyncRootFlow.OnStarted.ExecuteIfBound(Owner, nullptr);
+	}
+}
+
+void UFlowSubsystem::StartLoadedRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const bool bAllowMultipleInstances, const FFlowAsyncRootFlowEvent& OnStarted, const TSharedPtr<FStreamableHandle>& LoadHandle)
+{
+	if (PendingRootFlows.Num() > 0 || IsFrameBudgetExceeded())
+	{
+		if (FFlowPendingRootFlow* PendingRootFlow = QueueRootFlow(Owner, FlowAsset, bAllowMultipleInstances))
 		{
-			NewFlow->StartFlow();
+			// flow deferred by the frame budget holds only a weak pointer to the asset
+			PendingRootFlow->LoadHandle = LoadHandle;
+			PendingRootFlow->OnStarted = OnStarted;
 		}
+		else
+		{
+			OnStarted.ExecuteIfBound(Owner, nullptr);
+		}
+		return;
 	}
-#if WITH_EDITOR
-	else
+
+	BeginBudgetedWork();
+	UFlowAsset* NewFlow = CreateRootFlow(Owner, FlowAsset, bAllowMultipleInstances);
+	if (NewFlow)
 	{
-		FMessageLog("PIE").Error(LOCTEXT("StartRootFlowNullAsset", "Attempted to start Root Flow with a null asset."))
-		                  ->AddToken(FUObjectToken::Create(Owner));
+		NewFlow->StartFlow();
 	}
-#endif
+	EndBudgetedWork();
+
+	OnStarted.ExecuteIfBound(Owner, NewFlow);
 }
 
-UFlowAsset* UFlowSubsystem::CreateRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const bool bAllowMultipleInstances)
+void UFlowSubsystem::CancelAsyncRootFlows(const UObject* Owner, const UFlowAsset* TemplateAsset /* = nullptr */)
 {
-	for (const TPair<UFlowAsset*, TWeakObjectPtr<UObject>>& RootInstance : RootInstances)
+	// null Owner cancels all requests
+	for (int32 i = AsyncRootFlows.Num() - 1; i >= 0; i--)
 	{
-		if (Owner == RootInstance.Value.Get() && FlowAsset == RootInstance.Key->GetTemplateAsset())
+		const FFlowAsyncRootFlow& AsyncRootFlow = AsyncRootFlows[i];
+		if (Owner == nullptr || (AsyncRootFlow.Owner.Get() == Owner && (TemplateAsset == nullptr || AsyncRootFlow.FlowAsset.ToSoftObjectPath() == FSoftObjectPath(TemplateAsset))))
 		{
-			UE_LOG(LogFlow, Warning, TEXT("Attempted to start Root Flow for the same Owner again. Owner: %s. Flow Asset: %s."), *Owner->GetName(), *FlowAsset->GetName());
-			return nullptr;
+			const TSharedPtr<FStreamableHandle> LoadHandle = AsyncRootFlow.LoadHandle;
+			AsyncRootFlows.RemoveAt(i, 1, false);
+
+			if (LoadHandle.IsValid())
+			{
+				LoadHandle->CancelHandle();
+			}
 		}
 	}
+}
 
-	if (!bAllowMultipleInstances && InstancedTemplates.Contains(FlowAsset))
+FFlowAsyncSubFlow* UFlowSubsystem::FindAsyncSubFlow(const UFlowNode_SubGraph* SubGraphNode)
+{
+	return AsyncSubFlows.FindByPredicate([SubGraphNode](const FFlowAsyncSubFlow& AsyncSubFlow)
 	{
-		UE_LOG(LogFlow, Warning, TEXT("Attempted to start Root Flow, although there can be only a single instance. Owner: %s. Flow Asset: %s."), *Owner->GetName(), *FlowAsset->GetName());
-		return nullptr;
+		return AsyncSubFlow.SubGraphNode.Get() == SubGraphNode;
+	});
+}
+
+void UFlowSubsystem::RequestAsyncSubFlow(UFlowNode_SubGraph* SubGraphNode, const bool bStartRequested)
+{
+	AsyncSubFlows.Add(FFlowAsyncSubFlow(SubGraphNode, bStartRequested));
+	if (bStartRequested)
+	{
+		SchedulerStats.DeferredSubFlowStarts++;
 	}
 
-	UFlowAsset* NewFlow = CreateFlowInstance(Owner, FlowAsset);
-	if (NewFlow)
+	const TWeakObjectPtr<UFlowNode_SubGraph> WeakSubGraphNode(SubGraphNode);
+	const TSharedPtr<FStreamableHandle> LoadHandle = StreamableManager.RequestAsyncLoad(SubGraphNode->Asset.ToSoftObjectPath(), FStreamableDelegate::CreateUObject(this, &UFlowSubsystem::OnSubFlowAssetLoaded, WeakSubGraphNode));
+
+	// completion delegate might have been already called, if the asset was resident or loading failed immediately
+	if (FFlowAsyncSubFlow* AsyncSubFlow = FindAsyncSubFlow(SubGraphNode))
 	{
-		RootInstances.Add(NewFlow, Owner);
+		AsyncSubFlow->LoadHandle = LoadHandle;
 	}
+}
 
-	return NewFlow;
+bool UFlowSubsystem::QueueSubFlowCustomInput(const UFlowNode_SubGraph* SubGraphNode, const FName& EventName)
+{
+	// input triggered before Start is ignored, the same as with the synchronous SubGraph
+	FFlowAsyncSubFlow* AsyncSubFlow = FindAsyncSubFlow(SubGraphNode);
+	if (AsyncSubFlow && AsyncSubFlow->bStartRequested)
+	{
+		AsyncSubFlow->PendingCustomInputs.Add(EventName);
+		return true;
+	}
+
+	return false;
 }
 
-void UFlowSubsystem::FinishRootFlow(UObject* Owner, UFlowAsset* TemplateAsset, const EFlowFinishPolicy FinishPolicy)
+void UFlowSubsystem::OnSubFlowAssetLoaded(TWeakObjectPtr<UFlowNode_SubGraph> SubGraphNode)
 {
-	UFlowAsset* InstanceToFinish = nullptr;
+	FFlowAsyncSubFlow* AsyncSubFlow = SubGraphNode.IsValid() ? FindAsyncSubFlow(SubGraphNode.Get()) : nullptr;
+	if (AsyncSubFlow == nullptr)
+	{
+		return;
+	}
 
-	for (TPair<UFlowAsset*, TWeakObjectPtr<UObject>>& RootInstance : RootInstances)
+	if (SubGraphNode->Asset.Get() == nullptr)
 	{
-		if (Owner && Owner == RootInstance.Value.Get() && RootInstance.Key && RootInstance.Key->GetTemplateAsset() == TemplateAsset)
+		UE_LOG(LogFlow, Error, TEXT("Failed to load SubGraph asset. Flow Asset: %s. Node: %s."), *SubGraphNode->Asset.ToString(), *SubGraphNode->GetName());
+		const bool bStartRequested = AsyncSubFlow->bStartRequested;
+		CancelAsyncSubFlow(SubGraphNode.Get());
+
+		// don't leave graph waiting for the SubGraph that won't ever finish
+		if (bStartRequested)
 		{
-			InstanceToFinish = RootInstance.Key;
-			break;
+			SubGraphNode->Finish();
 		}
+		return;
 	}
 
-	if (InstanceToFinish)
+	AsyncSubFlow->bLoaded = true;
+	SchedulerStats.AsyncLoadedSubFlows++;
+	SchedulerStats.MaxAsyncLoadTimeMs = FMath::Max(SchedulerStats.MaxAsyncLoadTimeMs, static_cast<float>((FPlatformTime::Seconds() - AsyncSubFlow->RequestTime) * 1000.0));
+
+	// instancing happens in the scheduler tick, so a single frame doesn't create a whole hierarchy of SubGraphs
+	StartSchedulerTicker();
+}
+
+void UFlowSubsystem::CancelAsyncSubFlow(const UFlowNode_SubGraph* SubGraphNode)
+{
+	// null SubGraph cancels all requests
+	for (int32 i = AsyncSubFlows.Num() - 1; i >= 0; i--)
 	{
-		RootInstances.Remove(InstanceToFinish);
-		InstanceToFinish->FinishFlow(FinishPolicy);
+		if (SubGraphNode == nullptr || AsyncSubFlows[i].SubGraphNode.Get() == SubGraphNode)
+		{
+			const TSharedPtr<FStreamableHandle> LoadHandle = AsyncSubFlows[i].LoadHandle;
+			AsyncSubFlows.RemoveAt(i, 1, false);
+
+			if (LoadHandle.IsValid() && LoadHandle->IsLoadingInProgress())
+			{
+				LoadHandle->CancelHandle();
+			}
+		}
 	}
 }
 
-void UFlowSubsystem::FinishAllRootFlows(UObject* Owner, const EFlowFinishPolicy FinishPolicy)
+int32 UFlowSubsystem::InstantiateLoadedSubFlows()
 {
-	TArray<UFlowAsset*> InstancesToFinish;
+	int32 InstancedSubGraphs = 0;
 
-	for (TPair<UFlowAsset*, TWeakObjectPtr<UObject>>& RootInstance : RootInstances)
+	for (int32 i = 0; i < AsyncSubFlows.Num() && (InstancedSubGraphs == 0 || !IsFrameBudgetExceeded());)
 	{
-		if (Owner && Owner == RootInstance.Value.Get() && RootInstance.Key)
+		if (!AsyncSubFlows[i].bLoaded)
+		{
+			i++;
+			continue;
+		}
+
+		// handle keeps the asset loaded until the instance references it
+		const FFlowAsyncSubFlow AsyncSubFlow = AsyncSubFlows[i];
+		AsyncSubFlows.RemoveAt(i, 1, false);
+
+		UFlowNode_SubGraph* SubGraphNode = AsyncSubFlow.SubGraphNode.Get();
+		if (SubGraphNode && SubGraphNode->GetFlowAsset())
 		{
-			InstancesToFinish.Emplace(RootInstance.Key);
+			InstantiateSubFlow(SubGraphNode, FString(), !AsyncSubFlow.bStartRequested);
+			InstancedSubGraphs++;
+
+			for (const FName& EventName : AsyncSubFlow.PendingCustomInputs)
+			{
+				SubGraphNode->GetFlowAsset()->TriggerCustomInput_FromSubGraph(SubGraphNode, EventName);
+			}
 		}
 	}
 
-	for (UFlowAsset* InstanceToFinish : InstancesToFinish)
+	return InstancedSubGraphs;
+}
+
+void UFlowSubsystem::StartSchedulerTicker()
+{
+	if (!SchedulerTickerHandle.IsValid())
 	{
-		RootInstances.Remove(InstanceToFinish);
-		InstanceToFinish->FinishFlow(FinishPolicy);
+		SchedulerTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UFlowSubsystem::TickScheduler));
 	}
 }
 
-UFlowAsset* UFlowSubsystem::CreateSubFlow(UFlowNode_SubGraph* SubGraphNode, const FString SavedInstanceName, const bool bPreloading /* = false */)
+bool UFlowSubsystem::TickScheduler(float DeltaTime)
 {
-	UFlowAsset* NewInstance = nullptr;
+	BeginBudgetedWork();
 
-	if (!InstancedSubFlows.Contains(SubGraphNode))
+	if (AbortedInstances.Num() > 0)
 	{
-		const TWeakObjectPtr<UObject> Owner = SubGraphNode->GetFlowAsset() ? SubGraphNode->GetFlowAsset()->GetOwner() : nullptr;
-		NewInstance = CreateFlowInstance(Owner, SubGraphNode->Asset, SavedInstanceName);
+		FinishAbortedInstances();
+	}
 
-		if (NewInstance)
+	// continue graphs already running, instances are processed in order of deferring
+	if (DeferredSignalInstances.Num() > 0)
+	{
+		TArray<TWeakObjectPtr<UFlowAsset>> Instances = MoveTemp(DeferredSignalInstances);
+		DeferredSignalInstances.Reset();
+
+		int32 InstanceIndex = 0;
+		for (; InstanceIndex < Instances.Num(); InstanceIndex++)
 		{
-			InstancedSubFlows.Add(SubGraphNode, NewInstance);
+			if (UFlowAsset* FlowInstance = Instances[InstanceIndex].Get())
+			{
+				if (FlowInstance->HasQueuedSignals())
+				{
+					if (!HasSignalBudget())
+					{
+						break;
+					}
+
+					FlowInstance->DrainSignalQueue();
+				}
+			}
+		}
 
-			if (bPreloading)
+		// instances not reached in this frame go first in the next frame
+		for (int32 i = Instances.Num() - 1; i >= InstanceIndex; i--)
+		{
+			if (Instances[i].IsValid() && !DeferredSignalInstances.Contains(Instances[i]))
 			{
-				NewInstance->PreloadNodes();
+				DeferredSignalInstances.Insert(Instances[i], 0);
 			}
 		}
 	}
 
-	if (InstancedSubFlows.Contains(SubGraphNode) && !bPreloading)
+	// start pending Root Flows, at least one per frame so even the lowest priority eventually starts
+	int32 StartedRootFlows = 0;
+	while (PendingRootFlows.Num() > 0 && (StartedRootFlows == 0 || !IsFrameBudgetExceeded()))
 	{
-		// get instanced asset from map - in case it was already instanced by calling CreateSubFlow() with bPreloading == true
-		UFlowAsset* AssetInstance = InstancedSubFlows[SubGraphNode];
+		const FFlowPendingRootFlow PendingRootFlow = PendingRootFlows[0];
+		PendingRootFlows.RemoveAt(0, 1, false);
 
-		AssetInstance->NodeOwningThisAssetInstance = SubGraphNode;
-		SubGraphNode->GetFlowAsset()->ActiveSubGraphs.Add(SubGraphNode, AssetInstance);
+		UObject* Owner = PendingRootFlow.Owner.Get();
+		UFlowAsset* FlowAsset = PendingRootFlow.FlowAsset.Get();
+		if (Owner == nullptr || FlowAsset == nullptr)
+		{
+			continue;
+		}
 
-		// don't activate Start Node if we're loading Sub Graph from SaveGame
-		if (SavedInstanceName.IsEmpty())
+		SchedulerStats.MaxDeferredFrames = FMath::Max(SchedulerStats.MaxDeferredFrames, static_cast<int32>(GFrameCounter - PendingRootFlow.QueuedFrame));
+
+		UFlowAsset* NewFlow = CreateRootFlow(Owner, FlowAsset, PendingRootFlow.bAllowMultipleInstances);
+		if (NewFlow)
 		{
-			AssetInstance->StartFlow();
+			NewFlow->StartFlow();
 		}
+		PendingRootFlow.OnStarted.ExecuteIfBound(Owner, NewFlow);
+		StartedRootFlows++;
 	}
 
-	return NewInstance;
+	// instance at least one loaded SubGraph per frame, even if Root Flows used the whole budget
+	if (AsyncSubFlows.Num() > 0)
+	{
+		InstantiateLoadedSubFlows();
+	}
+
+	EndBudgetedWork();
+
+	if (PendingRootFlows.Num() > 0 || DeferredSignalInstances.Num() > 0 || AbortedInstances.Num() > 0 || AsyncSubFlows.ContainsByPredicate([](const FFlowAsyncSubFlow& AsyncSubFlow) { return AsyncSubFlow.bLoaded; }))
+	{
+		return true;
+	}
+
+	SchedulerTickerHandle.Reset();
+	return false;
 }
 
-void UFlowSubsystem::RemoveSubFlow(UFlowNode_SubGraph* SubGraphNode, const EFlowFinishPolicy FinishPolicy)
+void UFlowSubsystem::FinishAbortedInstances()
 {
-	if (InstancedSubFlows.Contains(SubGraphNode))
+	// finishing instance might abort another one
+	const TArray<TWeakObjectPtr<UFlowAsset>> Instances = MoveTemp(AbortedInstances);
+	AbortedInstances.Reset();
+
+	for (const TWeakObjectPtr<UFlowAsset>& WeakInstance : Instances)
 	{
-		UFlowAsset* AssetInstance = InstancedSubFlows[SubGraphNode];
-		AssetInstance->NodeOwningThisAssetInstance = nullptr;
+		// instance might have been finished or reused in the meantime
+		UFlowAsset* FlowInstance = WeakInstance.Get();
+		if (FlowInstance == nullptr || !FlowInstance->bAbortedBySignalLimit)
+		{
+			continue;
+		}
 
-		SubGraphNode->GetFlowAsset()->ActiveSubGraphs.Remove(SubGraphNode);
-		InstancedSubFlows.Remove(SubGraphNode);
+		if (UFlowNode_SubGraph* SubGraphNode = FlowInstance->GetNodeOwningThisAssetInstance())
+		{
+			// the same as reaching Finish node, SubGraph node removes the instance
+			SubGraphNode->TriggerFirstOutput(true);
+		}
+		else if (UObject* Owner = RootInstances.FindRef(FlowInstance).Get())
+		{
+			FinishRootFlow(Owner, FlowInstance->GetTemplateAsset(), EFlowFinishPolicy::Abort);
+		}
+		else
+		{
+			RootInstances.Remove(FlowInstance);
+			FlowInstance->FinishFlow(EFlowFinishPolicy::Abort);
+		}
+	}
+}
 
-		AssetInstance->FinishFlow(FinishPolicy);
+void UFlowSubsystem::BeginBudgetedWork()
+{
+	if (BudgetedWorkDepth++ > 0)
+	{
+		return;
+	}
+
+	if (TimeBudgetFrame != GFrameCounter)
+	{
+		TimeBudgetFrame = GFrameCounter;
+		TimeSpentInCurrentFrame = 0.0;
 	}
+
+	BudgetedWorkStartTime = FPlatformTime::Seconds();
 }
 
-UFlowAsset* UFlowSubsystem::CreateFlowInstance(const TWeakObjectPtr<UObject> Owner, TSoftObjectPtr<UFlowAsset> FlowAsset, FString NewInstanceName)
+void UFlowSubsystem::EndBudgetedWork()
 {
-	UFlowAsset* LoadedFlowAsset = FlowAsset.LoadSynchronous();
-	if (LoadedFlowAsset == nullptr)
+	if (--BudgetedWorkDepth > 0)
 	{
-		return nullptr;
+		return;
 	}
 
-	AddInstancedTemplate(LoadedFlowAsset);
+	const bool bWasExceeded = IsFrameBudgetExceeded();
+	TimeSpentInCurrentFrame += FPlatformTime::Seconds() - BudgetedWorkStartTime;
 
-#if WITH_EDITOR
-	if (GetWorld()->WorldType != EWorldType::Game)
+	SchedulerStats.LastFrameTimeMs = static_cast<float>(TimeSpentInCurrentFrame * 1000.0);
+	SchedulerStats.PeakFrameTimeMs = FMath::Max(SchedulerStats.PeakFrameTimeMs, SchedulerStats.LastFrameTimeMs);
+
+	if (!bWasExceeded && IsFrameBudgetExceeded())
 	{
-		// Fix connections - even in packaged game if assets haven't been re-saved in the editor after changing node's definition
-		LoadedFlowAsset->HarvestNodeConnections();
+		SchedulerStats.FramesOverBudget++;
 	}
-#endif
+}
 
-	// it won't be empty, if we're restoring Flow Asset instance from the SaveGame
-	if (NewInstanceName.IsEmpty())
+UFlowAsset* UFlowSubsystem::AcquirePooledInstance(UFlowAsset* Template)
+{
+	if (Template->InstancePoolSize <= 0)
 	{
-		NewInstanceName = MakeUniqueObjectName(this, UFlowAsset::StaticClass(), *FPaths::GetBaseFilename(LoadedFlowAsset->GetPathName())).ToString();
+		return nullptr;
 	}
 
-	UFlowAsset* NewInstance = NewObject<UFlowAsset>(this, LoadedFlowAsset->GetClass(), *NewInstanceName, RF_Transient, LoadedFlowAsset, false, nullptr);
-	NewInstance->InitializeInstance(Owner, LoadedFlowAsset);
+	FFlowInstancePool& Pool = InstancePools.FindOrAdd(Template);
+	const TSharedPtr<const FFlowCompiledGraph>& CompiledGraph = Template->GetCompiledGraph();
 
-	LoadedFlowAsset->AddInstance(NewInstance);
+	while (Pool.Instances.Num() > 0)
+	{
+		UFlowAsset* Instance = Pool.Instances.Pop(false);
 
-	return NewInstance;
+		// template might have been edited during PIE since the instance was created, and node sharing decides which nodes were instantiated
+		if (IsValid(Instance) && Instance->CompiledGraph == CompiledGraph && Instance->bShareStatelessNodes == UFlowSettings::Get()->bShareStatelessNodes)
+		{
+			Pool.Stats.Hits++;
+			return Instance;
+		}
+	}
+
+	Pool.Stats.Misses++;
+	return nullptr;
 }
 
-void UFlowSubsystem::AddInstancedTemplate(UFlowAsset* Template)
+void UFlowSubsystem::ReleaseFlowInstance(UFlowAsset* Instance)
 {
-	if (!InstancedTemplates.Contains(Template))
+	UFlowAsset* Template = Instance->GetTemplateAsset();
+	FFlowInstancePool& Pool = InstancePools.FindOrAdd(Template);
+
+	if (Pool.Instances.Num() < Template->InstancePoolSize && Instance->CompiledGraph == Template->GetCompiledGraph() && !Pool.Instances.Contains(Instance)
+		&& Template->CanPoolInstances())
 	{
-		InstancedTemplates.Add(Template);
+		// root flow might have finished itself, its old owner can't reach the instance after it's reused
+		UnregisterRootInstance(Instance);
 
-#if WITH_EDITOR
-		Template->RuntimeLog = MakeShareable(new FFlowMessageLog());
-		OnInstancedTemplateAdded.ExecuteIfBound(Template);
-#endif
+		Instance->ResetInstance();
+		Pool.Instances.Add(Instance);
+		Pool.Stats.Releases++;
+	}
+	else
+	{
+		Pool.Stats.Discards++;
 	}
 }
 
-void UFlowSubsystem::RemoveInstancedTemplate(UFlowAsset* Template)
+void UFlowSubsystem::EvictPooledInstance(const FString& InstanceName)
 {
-#if WITH_EDITOR
-	OnInstancedTemplateRemoved.ExecuteIfBound(Template);
-	Template->RuntimeLog.Reset();
-#endif
+	UFlowAsset* PooledInstance = FindObjectFast<UFlowAsset>(this, *InstanceName);
+	FFlowInstancePool* Pool = PooledInstance ? InstancePools.Find(PooledInstance->GetTemplateAsset()) : nullptr;
 
-	InstancedTemplates.Remove(Template);
+	if (Pool && Pool->Instances.RemoveSingle(PooledInstance) > 0)
+	{
+		// evicted instance will be garbage collected under the new name
+		PooledInstance->Rename(nullptr, nullptr, REN_DontCreateRedirectors | REN_NonTransactional);
+		Pool->Stats.Discards++;
+	}
 }
 
-TMap<UObject*, UFlowAsset*> UFlowSubsystem::GetRootInstances() const
+void UFlowSubsystem::WarmupInstancePool(UFlowAsset* Template, const int32 NumInstances)
 {
-	TMap<UObject*, UFlowAsset*> Result;
-	for (const TPair<UFlowAsset*, TWeakObjectPtr<UObject>>& RootInstance : RootInstances)
+	if (Template == nullptr || Template->InstancePoolSize <= 0 || !Template->CanPoolInstances())
 	{
-		Result.Emplace(RootInstance.Value.Get(), RootInstance.Key);
+		return;
+	}
+
+	FFlowInstancePool& Pool = InstancePools.FindOrAdd(Template);
+	const int32 NumToCreate = FMath::Min(NumInstances, Template->InstancePoolSize - Pool.Instances.Num());
+
+	for (int32 i = 0; i < NumToCreate; i++)
+	{
+		const FString NewInstanceName = MakeUniqueObjectName(this, UFlowAsset::StaticClass(), *FPaths::GetBaseFilename(Template->GetPathName())).ToString();
+		UFlowAsset* NewInstance = NewObject<UFlowAsset>(this, Template->GetClass(), *NewInstanceName, RF_Transient, Template, false, nullptr);
+
+		// nodes will be initialized after taking instance from the pool, when the owner is known
+		NewInstance->CreateNodeInstances(Template);
+
+		Pool.Instances.Add(NewInstance);
+		Pool.Stats.WarmedUp++;
 	}
-	return Result;
 }
 
-TSet<UFlowAsset*> UFlowSubsystem::GetRootInstancesByOwner(const UObject* Owner) const
+void UFlowSubsystem::EmptyInstancePools()
 {
-	TSet<UFlowAsset*> Result;
-	for (const TPair<UFlowAsset*, TWeakObjectPtr<UObject>>& RootInstance : RootInstances)
+	// pool keys reference templates, and the first instance of the template warms its pool up
+	InstancePools.Empty();
+}
+
+FFlowInstancePoolStats UFlowSubsystem::GetInstancePoolStats(const UFlowAsset* Template /* = nullptr */) const
+{
+	FFlowInstancePoolStats Result;
+
+	for (const TPair<UFlowAsset*, FFlowInstancePool>& Pool : InstancePools)
 	{
-		if (Owner && RootInstance.Value == Owner)
+		if (Template == nullptr || Pool.Key == Template)
 		{
-			Result.Emplace(RootInstance.Key);
+			Result += Pool.Value.Stats;
 		}
 	}
+
 	return Result;
 }
 
-UFlowAsset* UFlowSubsystem::GetRootFlow(const UObject* Owner) const
+void UFlowSubsystem::RegisterPreloadedNode(UFlowNode* Node)
 {
-	const TSet<UFlowAsset*> Result = GetRootInstancesByOwner(Owner);
-	if (Result.Num() > 0)
+	if (UFlowSettings::Get()->PreloadBudgetMB <= 0)
 	{
-		return Result.Array()[0];
+		return;
 	}
 
-	return nullptr;
+	PreloadEntries.Add(Node);
+	EnforcePreloadBudget(Node);
 }
 
-UWorld* UFlowSubsystem::GetWorld() const
+void UFlowSubsystem::UnregisterPreloadedNode(const UFlowNode* Node)
 {
-	return GetGameInstance()->GetWorld();
+	PreloadEntries.Remove(Node);
+	PreloadStats.PreloadedNodes = PreloadEntries.Num();
+	PreloadStats.EstimatedBytes = PreloadEntries.GetEstimatedBytes();
+}
+
+void UFlowSubsystem::TouchPreloadedNode(const UFlowNode* Node)
+{
+	PreloadEntries.Touch(Node);
+}
+
+void UFlowSubsystem::EnforcePreloadBudget(const UFlowNode* ProtectedNode)
+{
+	// content loaded asynchronously is counted once it arrives
+	PreloadEntries.MeasurePendingEntries();
+
+	// flushing SubGraph content finishes its instance, which unregisters its own preloads, so nodes are flushed after updating the list
+	TArray<UFlowNode*> NodesToFlush;
+	const int64 BudgetBytes = static_cast<int64>(UFlowSettings::Get()->PreloadBudgetMB) * 1024 * 1024;
+
+	if (PreloadEntries.GetEstimatedBytes() > BudgetBytes)
+	{
+		PreloadEntries.RemoveLeastRecentlyUsed(BudgetBytes, ProtectedNode, NodesToFlush);
+	}
+
+	const int64 EstimatedBytes = PreloadEntries.GetEstimatedBytes();
+	PreloadStats.PreloadedNodes = PreloadEntries.Num();
+	PreloadStats.EstimatedBytes = EstimatedBytes;
+	PreloadStats.PeakEstimatedBytes = FMath::Max(PreloadStats.PeakEstimatedBytes, EstimatedBytes);
+	PreloadStats.EvictedNodes += NodesToFlush.Num();
+
+	for (UFlowNode* Node : NodesToFlush)
+	{
+		if (IsValid(Node) && Node->GetFlowAsset())
+		{
+			UE_LOG(LogFlow, Verbose, TEXT("Flushing preloaded content of %s, preloads exceeded the budget of %d MB."), *Node->GetName(), UFlowSettings::Get()->PreloadBudgetMB);
+			Node->GetFlowAsset()->FlushPreloadedNode(Node);
+		}
+	}
+}
+
+void UFlowSubsystem::ResetPreloadStats()
+{
+	PreloadStats.PeakEstimatedBytes = PreloadStats.EstimatedBytes;
+	PreloadStats.EvictedNodes = 0;
 }
 
 void UFlowSubsystem::OnGameSaved(UFlowSaveGame* SaveGame)
 {
+	FLOW_SCOPE_TIMING(SaveGame);
+
 	// clear existing data, in case we received reused SaveGame instance
 	// we only remove data for the current world + global Flow Graph instances (i.e. not bound to any world if created by UGameInstanceSubsystem)
 	// we keep data bound to other worlds
@@ -425,6 +1394,7 @@ void UFlowSubsystem::RegisterComponent(UFlowComponent* Component)
 		if (Tag.IsValid())
 		{
 			FlowComponentRegistry.Emplace(Tag, Component);
+			FLOW_INC_GAUGE(RegisteredComponents, 1);
 		}
 	}
 
@@ -434,6 +1404,7 @@ void UFlowSubsystem::RegisterComponent(UFlowComponent* Component)
 void UFlowSubsystem::OnIdentityTagAdded(UFlowComponent* Component, const FGameplayTag& AddedTag)
 {
 	FlowComponentRegistry.Emplace(AddedTag, Component);
+	FLOW_INC_GAUGE(RegisteredComponents, 1);
 
 	// broadcast OnComponentRegistered only if this component wasn't present in the registry previously
 	if (Component->IdentityTags.Num() > 1)
@@ -451,6 +1422,7 @@ void UFlowSubsystem::OnIdentityTagsAdded(UFlowComponent* Component, const FGamep
 	for (const FGameplayTag& Tag : AddedTags)
 	{
 		FlowComponentRegistry.Emplace(Tag, Component);
+		FLOW_INC_GAUGE(RegisteredComponents, 1);
 	}
 
 	// broadcast OnComponentRegistered only if this component wasn't present in the registry previously
@@ -470,7 +1442,8 @@ void UFlowSubsystem::UnregisterComponent(UFlowComponent* Component)
 	{
 		if (Tag.IsValid())
 		{
-			FlowComponentRegistry.Remove(Tag, Component);
+			const int32 NumRemoved = FlowComponentRegistry.Remove(Tag, Component);
+			FLOW_DEC_GAUGE(RegisteredComponents, NumRemoved);
 		}
 	}
 
@@ -479,7 +1452,8 @@ void UFlowSubsystem::UnregisterComponent(UFlowComponent* Component)
 
 void UFlowSubsystem::OnIdentityTagRemoved(UFlowComponent* Component, const FGameplayTag& RemovedTag)
 {
-	FlowComponentRegistry.Remove(RemovedTag, Component);
+	const int32 NumRemoved = FlowComponentRegistry.Remove(RemovedTag, Component);
+	FLOW_DEC_GAUGE(RegisteredComponents, NumRemoved);
 
 	// broadcast OnComponentUnregistered only if this component isn't present in the registry anymore
 	if (Component->IdentityTags.Num() > 0)
@@ -496,7 +1470,8 @@ void UFlowSubsystem::OnIdentityTagsRemoved(UFlowComponent* Component, const FGam
 {
 	for (const FGameplayTag& Tag : RemovedTags)
 	{
-		FlowComponentRegistry.Remove(Tag, Component);
+		const int32 NumRemoved = FlowComponentRegistry.Remove(Tag, Component);
+		FLOW_DEC_GAUGE(RegisteredComponents, NumRemoved);
 	}
 
 	// broadcast OnComponentUnregistered only if this component isn't present in the registry anymore
@@ -614,6 +1589,9 @@ TMap<AActor*, UFlowComponent*> UFlowSubsystem::GetFlowActorsAndComponentsByTags(
 
 void UFlowSubsystem::FindComponents(const FGameplayTag& Tag, const bool bExactMatch, TArray<TWeakObjectPtr<UFlowComponent>>& OutComponents) const
 {
+	FLOW_TRACE_SCOPE("FlowSubsystem::FindComponents");
+	FLOW_INC_COUNTER(RegistryQueries);
+
 	if (bExactMatch)
 	{
 		FlowComponentRegistry.MultiFind(Tag, OutComponents);
@@ -632,6 +1610,8 @@ void UFlowSubsystem::FindComponents(const FGameplayTag& Tag, const bool bExactMa
 
 void UFlowSubsystem::FindComponents(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch, TSet<TWeakObjectPtr<UFlowComponent>>& OutComponents) const
 {
+	FLOW_TRACE_SCOPE("FlowSubsystem::FindComponentsByTags");
+
 	if (MatchType == EGameplayContainerMatchType::Any)
 	{
 		for (const FGameplayTag& Tag : Tags)
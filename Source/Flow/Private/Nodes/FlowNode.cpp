@@ -4,7 +4,10 @@
 #include "AddOns/FlowNodeAddOn.h"
 
 #include "FlowAsset.h"
+#include "FlowProfiling.h"
 #include "FlowSettings.h"
+#include "FlowSubsystem.h"
+#include "Types/FlowTrace.h"
 
 #include "Components/ActorComponent.h"
 #if WITH_EDITOR
@@ -31,6 +34,10 @@ UFlowNode::UFlowNode(const FObjectInitializer& ObjectInitializer)
 	, SignalMode(EFlowSignalMode::Enabled)
 	, bPreloaded(false)
 	, ActivationState(EFlowNodeState::NeverActivated)
+	, CompiledIndex(INDEX_NONE)
+	, bStateless(false)
+	, bReusable(false)
+	, StatelessExecutionInstance(nullptr)
 {
 #if WITH_EDITOR
 	Category = TEXT("Uncategorized");
@@ -337,6 +344,16 @@ void UFlowNode::RemoveUserOutput(const FName& PinName)
 TSet<UFlowNode*> UFlowNode::GetConnectedNodes() const
 {
 	TSet<UFlowNode*> Result;
+
+	if (const FFlowCompiledGraph* CompiledGraph = GetCompiledGraph())
+	{
+		for (const int32 ConnectedIndex : CompiledGraph->GetSuccessors(CompiledIndex))
+		{
+			Result.Emplace(GetFlowAsset()->GetNodeByIndex(ConnectedIndex));
+		}
+		return Result;
+	}
+
 	for (const TPair<FName, FConnectedPin>& Connection : Connections)
 	{
 		Result.Emplace(GetFlowAsset()->GetNode(Connection.Value.NodeGuid));
@@ -359,6 +376,11 @@ FName UFlowNode::GetPinConnectedToNode(const FGuid& OtherNodeGuid)
 
 bool UFlowNode::IsInputConnected(const FName& PinName) const
 {
+	if (const FFlowCompiledGraph* CompiledGraph = GetCompiledGraph())
+	{
+		return CompiledGraph->IsInputConnected(CompiledIndex, PinName);
+	}
+
 	if (GetFlowAsset())
 	{
 		for (const TPair<FGuid, UFlowNode*>& Pair : GetFlowAsset()->Nodes)
@@ -384,6 +406,25 @@ bool UFlowNode::IsOutputConnected(const FName& PinName) const
 	return OutputPins.Contains(PinName) && Connections.Contains(PinName);
 }
 
+const FFlowCompiledGraph* UFlowNode::GetCompiledGraph() const
+{
+	const UFlowAsset* FlowAsset = GetFlowAsset();
+	const FFlowCompiledGraph* CompiledGraph = FlowAsset ? FlowAsset->FindCompiledGraph() : nullptr;
+
+	if (CompiledGraph && CompiledGraph->IsValidNodeIndex(CompiledIndex) && CompiledGraph->Nodes[CompiledIndex].NodeGuid == NodeGuid)
+	{
+		return CompiledGraph;
+	}
+
+	return nullptr;
+}
+
+TConstArrayView<int32> UFlowNode::GetConnectedNodeIndices() const
+{
+	const FFlowCompiledGraph* CompiledGraph = GetCompiledGraph();
+	return CompiledGraph ? CompiledGraph->GetSuccessors(CompiledIndex) : TConstArrayView<int32>();
+}
+
 void UFlowNode::RecursiveFindNodesByClass(UFlowNode* Node, const TSubclassOf<UFlowNode> Class, uint8 Depth, TArray<UFlowNode*>& OutNodes)
 {
 	if (Node)
@@ -400,6 +441,15 @@ void UFlowNode::RecursiveFindNodesByClass(UFlowNode* Node, const TSubclassOf<UFl
 		}
 
 		// Recurse
+		if (Node->GetCompiledGraph())
+		{
+			for (const int32 ConnectedIndex : Node->GetConnectedNodeIndices())
+			{
+				RecursiveFindNodesByClass(Node->GetFlowAsset()->GetNodeByIndex(ConnectedIndex), Class, Depth, OutNodes);
+			}
+			return;
+		}
+
 		for (UFlowNode* ConnectedNode : Node->GetConnectedNodes())
 		{
 			RecursiveFindNodesByClass(ConnectedNode, Class, Depth, OutNodes);
@@ -411,60 +461,90 @@ void UFlowNode::TriggerPreload()
 {
 	bPreloaded = true;
 	PreloadContent();
+
+	if (UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
+	{
+		FlowSubsystem->RegisterPreloadedNode(this);
+	}
 }
 
 void UFlowNode::TriggerFlush()
 {
+	UFlowSubsystem* FlowSubsystem = GetFlowSubsystem();
+	if (FlowSubsystem && !FlowSubsystem->IsTearingDown())
+	{
+		FlowSubsystem->UnregisterPreloadedNode(this);
+	}
+
 	bPreloaded = false;
 	FlushContent();
 }
 
 void UFlowNode::TriggerInput(const FName& PinName, const EFlowPinActivationType ActivationType /*= Default*/)
 {
-	if (SignalMode == EFlowSignalMode::Disabled)
+	const int32 PinIndex = InputPins.IndexOfByKey(PinName);
+	if (PinIndex == INDEX_NONE)
 	{
-		// entirely ignore any Input activation
+#if !UE_BUILD_SHIPPING
+		LogError(FString::Printf(TEXT("Input Pin name %s invalid"), *PinName.ToString()));
+#endif // UE_BUILD_SHIPPING
+		return;
 	}
 
-	if (InputPins.Contains(PinName))
-	{
-		if (SignalMode == EFlowSignalMode::Enabled)
-		{
-			const EFlowNodeState PreviousActivationState = ActivationState;
-			if (PreviousActivationState != EFlowNodeState::Active)
-			{
-				OnActivate();
-			}
-
-			ActivationState = EFlowNodeState::Active;
-		}
+	TriggerInputByIndex(PinIndex, ActivationType);
+}
 
+void UFlowNode::TriggerInputByIndex(const int32 PinIndex, const EFlowPinActivationType ActivationType /*= Default*/)
+{
+	if (!InputPins.IsValidIndex(PinIndex))
+	{
 #if !UE_BUILD_SHIPPING
-		// record for debugging
-		TArray<FPinRecord>& Records = InputRecords.FindOrAdd(PinName);
-		Records.Add(FPinRecord(FApp::GetCurrentTime(), ActivationType));
+		LogError(FString::Printf(TEXT("Input Pin index %d invalid"), PinIndex));
 #endif // UE_BUILD_SHIPPING
+		return;
+	}
 
-#if WITH_EDITOR
-		if (GEditor && UFlowAsset::GetFlowGraphInterface().IsValid())
+	FLOW_TRACE_NODE_SCOPE("TriggerInput", this);
+	FLOW_INC_COUNTER(Signals);
+
+	const FName PinName = InputPins[PinIndex].PinName;
+
+	if (FFlowTraceRecorder::IsRecording())
+	{
+		FFlowTraceRecorder::Get().RecordSignal(this, EFlowTraceEventType::Input, PinIndex, ActivationType);
+	}
+
+	if (SignalMode == EFlowSignalMode::Enabled)
+	{
+		const EFlowNodeState PreviousActivationState = ActivationState;
+		if (PreviousActivationState != EFlowNodeState::Active)
 		{
-			UFlowAsset::GetFlowGraphInterface()->OnInputTriggered(GraphNode, InputPins.IndexOfByKey(PinName));
+			OnActivate();
 		}
-#endif // WITH_EDITOR
+
+		ActivationState = EFlowNodeState::Active;
 	}
-	else
-	{
+
 #if !UE_BUILD_SHIPPING
-		LogError(FString::Printf(TEXT("Input Pin name %s invalid"), *PinName.ToString()));
+	// record for debugging
+	RecordPinActivation(InputRecords, InputPins.Num(), PinIndex, ActivationType);
 #endif // UE_BUILD_SHIPPING
-		return;
+
+#if WITH_EDITOR
+	if (GEditor && UFlowAsset::GetFlowGraphInterface().IsValid())
+	{
+		UFlowAsset::GetFlowGraphInterface()->OnInputTriggered(GraphNode, PinIndex);
 	}
+#endif // WITH_EDITOR
 
 	switch (SignalMode)
 	{
 		case EFlowSignalMode::Enabled:
+		{
+			FLOW_TRACE_NODE_SCOPE("ExecuteInput", this);
 			ExecuteInput(PinName);
 			break;
+		}
 		case EFlowSignalMode::Disabled:
 			if (UFlowSettings::Get()->bLogOnSignalDisabled)
 			{
@@ -498,17 +578,18 @@ void UFlowNode::TriggerOutput(const FName PinName, const bool bFinish /*= false*
 		Finish();
 	}
 
+	const int32 PinIndex = OutputPins.IndexOfByKey(PinName);
+
 #if !UE_BUILD_SHIPPING
-	if (OutputPins.Contains(PinName))
+	if (PinIndex != INDEX_NONE)
 	{
 		// record for debugging, even if nothing is connected to this pin
-		TArray<FPinRecord>& Records = OutputRecords.FindOrAdd(PinName);
-		Records.Add(FPinRecord(FApp::GetCurrentTime(), ActivationType));
+		RecordPinActivation(OutputRecords, OutputPins.Num(), PinIndex, ActivationType);
 
 #if WITH_EDITOR
 		if (GEditor && UFlowAsset::GetFlowGraphInterface().IsValid())
 		{
-			UFlowAsset::GetFlowGraphInterface()->OnOutputTriggered(GraphNode, OutputPins.IndexOfByKey(PinName));
+			UFlowAsset::GetFlowGraphInterface()->OnOutputTriggered(GraphNode, PinIndex);
 		}
 #endif // WITH_EDITOR
 	}
@@ -519,13 +600,33 @@ void UFlowNode::TriggerOutput(const FName PinName, const bool bFinish /*= false*
 #endif // UE_BUILD_SHIPPING
 
 	// call the next node
-	if (OutputPins.Contains(PinName) && Connections.Contains(PinName))
+	if (PinIndex != INDEX_NONE)
 	{
-		const FConnectedPin FlowPin = GetConnection(PinName);
-		GetFlowAsset()->TriggerInput(FlowPin.NodeGuid, FlowPin.PinName);
+		if (FFlowTraceRecorder::IsRecording())
+		{
+			FFlowTraceRecorder::Get().RecordSignal(this, EFlowTraceEventType::Output, PinIndex, ActivationType);
+		}
+
+		GetFlowAsset()->TriggerConnectedInput(this, PinIndex);
 	}
 }
 
+#if !UE_BUILD_SHIPPING
+void UFlowNode::RecordPinActivation(TArray<FPinRecordBuffer>& Records, const int32 NumPins, const int32 PinIndex, const EFlowPinActivationType ActivationType) const
+{
+	const int32 Capacity = GetFlowAsset()->GetPinRecordCapacity();
+	if (Capacity > 0)
+	{
+		if (Records.Num() < NumPins)
+		{
+			Records.SetNum(NumPins);
+		}
+
+		Records[PinIndex].Add(FPinRecord(FApp::GetCurrentTime(), ActivationType), Capacity);
+	}
+}
+#endif
+
 void UFlowNode::Finish()
 {
 	Deactivate();
@@ -619,13 +720,21 @@ void UFlowNode::OnPassThrough_Implementation()
 	Finish();
 }
 
+bool UFlowNode::HasDefaultPassThrough() const
+{
+	return false;
+}
+
 #if WITH_EDITOR
 TMap<uint8, FPinRecord> UFlowNode::GetWireRecords() const
 {
 	TMap<uint8, FPinRecord> Result;
-	for (const TPair<FName, TArray<FPinRecord>>& Record : OutputRecords)
+	for (int32 PinIndex = 0; PinIndex < OutputRecords.Num(); PinIndex++)
 	{
-		Result.Emplace(OutputPins.IndexOfByKey(Record.Key), Record.Value.Last());
+		if (OutputRecords[PinIndex].Num() > 0)
+		{
+			Result.Emplace(PinIndex, OutputRecords[PinIndex].Last());
+		}
 	}
 	return Result;
 }
@@ -635,9 +744,15 @@ TArray<FPinRecord> UFlowNode::GetPinRecords(const FName& PinName, const EEdGraph
 	switch (PinDirection)
 	{
 		case EGPD_Input:
-			return InputRecords.FindRef(PinName);
+		{
+			const int32 PinIndex = InputPins.IndexOfByKey(PinName);
+			return InputRecords.IsValidIndex(PinIndex) ? InputRecords[PinIndex].GetRecords() : TArray<FPinRecord>();
+		}
 		case EGPD_Output:
-			return OutputRecords.FindRef(PinName);
+		{
+			const int32 PinIndex = OutputPins.IndexOfByKey(PinName);
+			return OutputRecords.IsValidIndex(PinIndex) ? OutputRecords[PinIndex].GetRecords() : TArray<FPinRecord>();
+		}
 		default:
 			return TArray<FPinRecord>();
 	}
@@ -235,6 +235,11 @@ UFlowAsset* UFlowNodeBase::GetFlowAsset() const
 {
 	// In the case of an AddOn, we want our containing FlowNode's Outer, not our own
 	const UFlowNode* FlowNode = GetFlowNodeSelfOrOwner();
+	if (FlowNode && FlowNode->GetStatelessExecutionInstance())
+	{
+		return FlowNode->GetStatelessExecutionInstance();
+	}
+
 	return FlowNode && FlowNode->GetOuter() ? Cast<UFlowAsset>(FlowNode->GetOuter()) : Cast<UFlowAsset>(GetOuter());
 }
 
@@ -2,8 +2,6 @@
 
 #include "Nodes/FlowPin.h"
 
-#include "Misc/DateTime.h"
-
 #include UE_INLINE_GENERATED_CPP_BY_NAME(FlowPin)
 
 //////////////////////////////////////////////////////////////////////////
@@ -17,17 +15,20 @@ FString FPinRecord::PassThroughActivation = TEXT(" (pass-through activation)");
 
 FPinRecord::FPinRecord()
 	: Time(0.0f)
-	, HumanReadableTime(FString())
 	, ActivationType(EFlowPinActivationType::Default)
 {
 }
 
 FPinRecord::FPinRecord(const double InTime, const EFlowPinActivationType InActivationType)
 	: Time(InTime)
+	, SystemTime(FDateTime::Now())
 	, ActivationType(InActivationType)
 {
-	const FDateTime SystemTime(FDateTime::Now());
-	HumanReadableTime = DoubleDigit(SystemTime.GetHour()) + TEXT(".")
+}
+
+FString FPinRecord::GetHumanReadableTime() const
+{
+	return DoubleDigit(SystemTime.GetHour()) + TEXT(".")
 		+ DoubleDigit(SystemTime.GetMinute()) + TEXT(".")
 		+ DoubleDigit(SystemTime.GetSecond()) + TEXT(":")
 		+ DoubleDigit(SystemTime.GetMillisecond()).Left(3);
@@ -37,6 +38,45 @@ FORCEINLINE FString FPinRecord::DoubleDigit(const int32 Number)
 {
 	return Number > 9 ? FString::FromInt(Number) : TEXT("0") + FString::FromInt(Number);
 }
+
+void FPinRecordBuffer::Add(const FPinRecord& Record, const int32 Capacity)
+{
+	if (Records.Num() < Capacity)
+	{
+		Records.Reserve(Capacity);
+		Records.Add(Record);
+		NextRecord = Records.Num() % Capacity;
+	}
+	else if (Records.Num() > 0)
+	{
+		Records[NextRecord] = Record;
+		NextRecord = (NextRecord + 1) % Records.Num();
+	}
+}
+
+void FPinRecordBuffer::Reset()
+{
+	Records.Empty();
+	NextRecord = 0;
+}
+
+const FPinRecord& FPinRecordBuffer::Last() const
+{
+	return Records[(NextRecord + Records.Num() - 1) % Records.Num()];
+}
+
+TArray<FPinRecord> FPinRecordBuffer::GetRecords() const
+{
+	TArray<FPinRecord> Result;
+	Result.Reserve(Records.Num());
+
+	for (int32 i = 0; i < Records.Num(); i++)
+	{
+		Result.Add(Records[(NextRecord + i) % Records.Num()]);
+	}
+
+	return Result;
+}
 #endif
 
 //////////////////////////////////////////////////////////////////////////
@@ -13,6 +13,7 @@ UFlowNode_LogicalAND::UFlowNode_LogicalAND(const FObjectInitializer& ObjectIniti
 #endif
 
 	SetNumberedInputPins(0, 1);
+	bReusable = true;
 }
 
 void UFlowNode_LogicalAND::ExecuteInput(const FName& PinName)
@@ -24,6 +24,7 @@ UFlowNode_Branch::UFlowNode_Branch(const FObjectInitializer& ObjectInitializer)
 	OutputPins.Add(FFlowPin(OUTPIN_False));
 
 	AllowedSignalModes = { EFlowSignalMode::Enabled, EFlowSignalMode::Disabled };
+	bStateless = true;
 }
 
 EFlowAddOnAcceptResult UFlowNode_Branch::AcceptFlowNodeAddOnChild_Implementation(const UFlowNodeAddOn* AddOnTemplate) const
@@ -24,6 +24,7 @@ UFlowNode_Counter::UFlowNode_Counter(const FObjectInitializer& ObjectInitializer
 	OutputPins.Add(FFlowPin(TEXT("Step")));
 	OutputPins.Add(FFlowPin(TEXT("Goal")));
 	OutputPins.Add(FFlowPin(TEXT("Skipped")));
+	bReusable = true;
 }
 
 void UFlowNode_Counter::ExecuteInput(const FName& PinName)
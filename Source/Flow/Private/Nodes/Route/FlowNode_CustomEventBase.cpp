@@ -14,6 +14,7 @@ UFlowNode_CustomEventBase::UFlowNode_CustomEventBase(const FObjectInitializer& O
 #endif
 
 	AllowedSignalModes = {EFlowSignalMode::Enabled, EFlowSignalMode::Disabled};
+	bReusable = true;
 }
 
 void UFlowNode_CustomEventBase::SetEventName(const FName& InEventName)
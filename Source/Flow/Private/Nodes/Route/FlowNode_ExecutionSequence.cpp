@@ -15,6 +15,8 @@ UFlowNode_ExecutionSequence::UFlowNode_ExecutionSequence(const FObjectInitialize
 
 	SetNumberedOutputPins(0, 1);
 	AllowedSignalModes = {EFlowSignalMode::Enabled, EFlowSignalMode::Disabled};
+	bStateless = true;
+	bReusable = true;
 }
 
 void UFlowNode_ExecutionSequence::ExecuteInput(const FName& PinName)
@@ -14,6 +14,7 @@ UFlowNode_Finish::UFlowNode_Finish(const FObjectInitializer& ObjectInitializer)
 
 	OutputPins = {};
 	AllowedSignalModes = {EFlowSignalMode::Enabled, EFlowSignalMode::Disabled};
+	bReusable = true;
 }
 
 void UFlowNode_Finish::ExecuteInput(const FName& PinName)
@@ -15,6 +15,7 @@ UFlowNode_Start::UFlowNode_Start(const FObjectInitializer& ObjectInitializer)
 
 	InputPins = {};
 	AllowedSignalModes = {EFlowSignalMode::Enabled, EFlowSignalMode::Disabled};
+	bStateless = true;
 }
 
 void UFlowNode_Start::ExecuteInput(const FName& PinName)
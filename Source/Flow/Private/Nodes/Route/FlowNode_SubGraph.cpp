@@ -5,6 +5,9 @@
 #include "FlowAsset.h"
 #include "FlowSubsystem.h"
 
+#include "Serialization/ArchiveCountMem.h"
+#include "UObject/UObjectHash.h"
+
 #include UE_INLINE_GENERATED_CPP_BY_NAME(FlowNode_SubGraph)
 
 FFlowPin UFlowNode_SubGraph::StartPin(TEXT("Start"));
@@ -23,6 +26,7 @@ UFlowNode_SubGraph::UFlowNode_SubGraph(const FObjectInitializer& ObjectInitializ
 
 	InputPins = {StartPin};
 	OutputPins = {FinishPin};
+	bReusable = true;
 }
 
 bool UFlowNode_SubGraph::CanBeAssetInstanced() const
@@ -46,6 +50,24 @@ void UFlowNode_SubGraph::FlushContent()
 	}
 }
 
+int64 UFlowNode_SubGraph::EstimatePreloadedMemory()
+{
+	UFlowAsset* AssetInstance = GetFlowSubsystem() ? GetFlowSubsystem()->GetInstancedSubFlows().FindRef(this) : nullptr;
+	if (AssetInstance == nullptr)
+	{
+		return 0;
+	}
+
+	// preloaded instance together with its node instances
+	int64 Size = FArchiveCountMem(AssetInstance).GetMax();
+	ForEachObjectWithOuter(AssetInstance, [&Size](UObject* Object)
+	{
+		Size += FArchiveCountMem(Object).GetMax();
+	});
+
+	return Size;
+}
+
 void UFlowNode_SubGraph::ExecuteInput(const FName& PinName)
 {
 	if (CanBeAssetInstanced() == false)
@@ -72,6 +94,12 @@ void UFlowNode_SubGraph::ExecuteInput(const FName& PinName)
 	}
 	else if (!PinName.IsNone())
 	{
+		// SubGraph still being prepared receives the input after it starts
+		if (GetFlowSubsystem() && GetFlowSubsystem()->QueueSubFlowCustomInput(this, PinName))
+		{
+			return;
+		}
+
 		GetFlowAsset()->TriggerCustomInput_FromSubGraph(this, PinName);
 	}
 }
@@ -13,6 +13,8 @@ UFlowNode_Checkpoint::UFlowNode_Checkpoint(const FObjectInitializer& ObjectIniti
 #if WITH_EDITOR
 	Category = TEXT("Utils");
 #endif
+
+	bReusable = true;
 }
 
 void UFlowNode_Checkpoint::ExecuteInput(const FName& PinName)
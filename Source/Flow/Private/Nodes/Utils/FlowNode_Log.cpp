@@ -18,6 +18,8 @@ UFlowNode_Log::UFlowNode_Log(const FObjectInitializer& ObjectInitializer)
 #if WITH_EDITOR
 	Category = TEXT("Utils");
 #endif
+
+	bReusable = true;
 }
 
 void UFlowNode_Log::ExecuteInput(const FName& PinName)
@@ -18,6 +18,7 @@ UFlowNode_ComponentObserver::UFlowNode_ComponentObserver(const FObjectInitialize
 
 	InputPins = {FFlowPin(TEXT("Start")), FFlowPin(TEXT("Stop"))};
 	OutputPins = {FFlowPin(TEXT("Success")), FFlowPin(TEXT("Completed")), FFlowPin(TEXT("Stopped"))};
+	bReusable = true;
 }
 
 void UFlowNode_ComponentObserver::ExecuteInput(const FName& PinName)
@@ -77,7 +78,9 @@ void UFlowNode_ComponentObserver::StartObserving()
 
 void UFlowNode_ComponentObserver::StopObserving()
 {
-	if (UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
+	// subsystem tearing down all flows removes bindings of all nodes at once
+	UFlowSubsystem* FlowSubsystem = GetFlowSubsystem();
+	if (FlowSubsystem && !FlowSubsystem->IsTearingDown())
 	{
 		FlowSubsystem->OnComponentRegistered.RemoveAll(this);
 		FlowSubsystem->OnComponentUnregistered.RemoveAll(this);
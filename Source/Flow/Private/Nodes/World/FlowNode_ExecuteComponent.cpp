@@ -23,6 +23,8 @@ UFlowNode_ExecuteComponent::UFlowNode_ExecuteComponent()
 	NodeStyle = EFlowNodeStyle::Default;
 	Category = TEXT("World");
 #endif // WITH_EDITOR
+
+	bReusable = true;
 }
 
 void UFlowNode_ExecuteComponent::InitializeInstance()
@@ -18,6 +18,8 @@ UFlowNode_NotifyActor::UFlowNode_NotifyActor(const FObjectInitializer& ObjectIni
 #if WITH_EDITOR
 	Category = TEXT("Notifies");
 #endif
+
+	bReusable = true;
 }
 
 void UFlowNode_NotifyActor::ExecuteInput(const FName& PinName)
@@ -15,6 +15,7 @@
 #include "LevelSequence.h"
 #include "LevelSequenceActor.h"
 #include "Runtime/Launch/Resources/Version.h"
+#include "UObject/UObjectHash.h"
 #include "VisualLogger/VisualLogger.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(FlowNode_PlayLevelSequence)
@@ -51,6 +52,7 @@ UFlowNode_PlayLevelSequence::UFlowNode_PlayLevelSequence(const FObjectInitialize
 	OutputPins.Add(FFlowPin(TEXT("Started")));
 	OutputPins.Add(FFlowPin(TEXT("Completed")));
 	OutputPins.Add(FFlowPin(TEXT("Stopped")));
+	bReusable = true;
 }
 
 #if WITH_EDITOR
@@ -130,6 +132,51 @@ void UFlowNode_PlayLevelSequence::FlushContent()
 	}
 }
 
+int64 UFlowNode_PlayLevelSequence::EstimatePreloadedMemory()
+{
+	// sequence is loaded asynchronously, it doesn't take memory until it arrives
+	ULevelSequence* PreloadedSequence = Sequence.Get();
+	if (PreloadedSequence == nullptr)
+	{
+		return 0;
+	}
+
+	// the sequence with its tracks and sections
+	TArray<UObject*> SequenceObjects;
+	GetObjectsWithOuter(PreloadedSequence, SequenceObjects, true);
+	SequenceObjects.Add(PreloadedSequence);
+
+	// assets referenced by the sequence, i.e. animations and sounds
+	// these might be used by something else, so the estimate is the upper bound of memory freed by flushing the sequence
+	TArray<UObject*> ReferencedObjects;
+	FReferenceFinder ReferenceFinder(ReferencedObjects, nullptr, false, true, false, true);
+	for (UObject* Object : SequenceObjects)
+	{
+		ReferenceFinder.FindReferences(Object);
+	}
+
+	TSet<UObject*> MeasuredObjects(SequenceObjects);
+	for (UObject* Object : ReferencedObjects)
+	{
+		if (Object && !Object->IsA<UField>() && !Object->IsIn(PreloadedSequence) && Object->IsAsset())
+		{
+			MeasuredObjects.Add(Object);
+		}
+	}
+
+	int64 Size = 0;
+	for (UObject* Object : MeasuredObjects)
+	{
+		Size += Object->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+	}
+	return Size;
+}
+
+UObject* UFlowNode_PlayLevelSequence::GetPreloadedAsset() const
+{
+	return Sequence.Get();
+}
+
 void UFlowNode_PlayLevelSequence::InitializeInstance()
 {
 	Super::InitializeInstance();
@@ -0,0 +1,485 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Types/FlowCompiledGraph.h"
+#include "Nodes/FlowNode.h"
+#include "Nodes/Route/FlowNode_CustomInput.h"
+#include "Nodes/Route/FlowNode_CustomOutput.h"
+#include "Nodes/Route/FlowNode_Reroute.h"
+#include "Nodes/Route/FlowNode_Start.h"
+
+void FFlowCompiledGraph::Build(const TMap<FGuid, UFlowNode*>& InNodes, const bool bOptimize /* = false */)
+{
+	Reset();
+
+	Nodes.Reserve(InNodes.Num());
+	NodeIndices.Reserve(InNodes.Num());
+
+	// assign node indices and flatten pins
+	for (const TPair<FGuid, UFlowNode*>& Pair : InNodes)
+	{
+		const UFlowNode* Node = Pair.Value;
+		if (Node == nullptr)
+		{
+			continue;
+		}
+
+		FFlowCompiledNode& CompiledNode = Nodes.AddDefaulted_GetRef();
+		CompiledNode.NodeGuid = Pair.Key;
+
+		CompiledNode.FirstInputPin = InputPinNames.Num();
+		CompiledNode.NumInputPins = Node->GetInputPins().Num();
+		for (const FFlowPin& Pin : Node->GetInputPins())
+		{
+			InputPinNames.Emplace(Pin.PinName);
+		}
+
+		CompiledNode.FirstOutputPin = OutputPinNames.Num();
+		CompiledNode.NumOutputPins = Node->GetOutputPins().Num();
+		for (const FFlowPin& Pin : Node->GetOutputPins())
+		{
+			OutputPinNames.Emplace(Pin.PinName);
+		}
+
+		NodeIndices.Emplace(Pair.Key, Nodes.Num() - 1);
+	}
+
+	// resolve connections to indices
+	OutputConnections.SetNum(OutputPinNames.Num());
+
+	for (const FFlowCompiledNode& CompiledNode : Nodes)
+	{
+		const UFlowNode* Node = InNodes.FindChecked(CompiledNode.NodeGuid);
+
+		for (int32 PinIndex = 0; PinIndex < CompiledNode.NumOutputPins; PinIndex++)
+		{
+			const FConnectedPin ConnectedPin = Node->GetConnection(OutputPinNames[CompiledNode.FirstOutputPin + PinIndex]);
+			const int32 ConnectedNodeIndex = FindNodeIndex(ConnectedPin.NodeGuid);
+			if (ConnectedNodeIndex == INDEX_NONE)
+			{
+				continue;
+			}
+
+			FFlowCompiledConnection& Connection = OutputConnections[CompiledNode.FirstOutputPin + PinIndex];
+			Connection.NodeIndex = ConnectedNodeIndex;
+			Connection.InputPinName = ConnectedPin.PinName;
+
+			Connection.InputPinIndex = FindInputPinIndex(ConnectedNodeIndex, ConnectedPin.PinName);
+		}
+	}
+
+	TArray<const UFlowNode*> NodeObjects;
+	NodeObjects.Reserve(Nodes.Num());
+	for (const FFlowCompiledNode& CompiledNode : Nodes)
+	{
+		NodeObjects.Emplace(InNodes.FindChecked(CompiledNode.NodeGuid));
+	}
+
+	BuildAdjacency(NodeObjects);
+	BuildLookups(NodeObjects);
+
+	if (bOptimize)
+	{
+		Optimize(NodeObjects);
+	}
+}
+
+void FFlowCompiledGraph::BuildAdjacency(const TArray<const UFlowNode*>& NodeObjects)
+{
+	ConnectedInputPins.Init(false, InputPinNames.Num());
+
+	// successors follow the order of node connections, so queries iterate graph the same way as UFlowNode::GetConnectedNodes
+	TArray<int32> NumNodePredecessors;
+	NumNodePredecessors.SetNumZeroed(Nodes.Num());
+
+	for (int32 NodeIndex = 0; NodeIndex < Nodes.Num(); NodeIndex++)
+	{
+		FFlowCompiledNode& CompiledNode = Nodes[NodeIndex];
+		CompiledNode.FirstSuccessor = Successors.Num();
+
+		for (const TPair<FName, FConnectedPin>& Connection : NodeObjects[NodeIndex]->Connections)
+		{
+			const int32 ConnectedNodeIndex = FindNodeIndex(Connection.Value.NodeGuid);
+			if (ConnectedNodeIndex == INDEX_NONE)
+			{
+				continue;
+			}
+
+			const int32 InputPinIndex = FindInputPinIndex(ConnectedNodeIndex, Connection.Value.PinName);
+			if (InputPinIndex != INDEX_NONE)
+			{
+				ConnectedInputPins[Nodes[ConnectedNodeIndex].FirstInputPin + InputPinIndex] = true;
+			}
+
+			if (!GetSuccessors(NodeIndex).Contains(ConnectedNodeIndex))
+			{
+				Successors.Emplace(ConnectedNodeIndex);
+				CompiledNode.NumSuccessors++;
+				NumNodePredecessors[ConnectedNodeIndex]++;
+			}
+		}
+	}
+
+	// reverse adjacency, filled in a single pass over ranges sized upfront
+	int32 NumAllPredecessors = 0;
+	for (int32 NodeIndex = 0; NodeIndex < Nodes.Num(); NodeIndex++)
+	{
+		Nodes[NodeIndex].FirstPredecessor = NumAllPredecessors;
+		NumAllPredecessors += NumNodePredecessors[NodeIndex];
+	}
+
+	Predecessors.SetNumUninitialized(NumAllPredecessors);
+	for (int32 NodeIndex = 0; NodeIndex < Nodes.Num(); NodeIndex++)
+	{
+		for (const int32 SuccessorIndex : GetSuccessors(NodeIndex))
+		{
+			FFlowCompiledNode& Successor = Nodes[SuccessorIndex];
+			Predecessors[Successor.FirstPredecessor + Successor.NumPredecessors] = NodeIndex;
+			Successor.NumPredecessors++;
+		}
+	}
+}
+
+void FFlowCompiledGraph::BuildLookups(const TArray<const UFlowNode*>& NodeObjects)
+{
+	int32 FirstStartNode = INDEX_NONE;
+
+	for (int32 NodeIndex = 0; NodeIndex < Nodes.Num(); NodeIndex++)
+	{
+		NodesByClass.FindOrAdd(NodeObjects[NodeIndex]->GetClass()).Emplace(NodeIndex);
+
+		if (const UFlowNode_CustomInput* CustomInput = Cast<UFlowNode_CustomInput>(NodeObjects[NodeIndex]))
+		{
+			CustomInputNames.Emplace(CustomInput->GetEventName());
+			if (!CustomInput->GetEventName().IsNone())
+			{
+				CustomInputNodes.FindOrAdd(CustomInput->GetEventName()).Emplace(NodeIndex);
+			}
+		}
+		else if (const UFlowNode_CustomOutput* CustomOutput = Cast<UFlowNode_CustomOutput>(NodeObjects[NodeIndex]))
+		{
+			CustomOutputNames.Emplace(CustomOutput->GetEventName());
+			if (!CustomOutput->GetEventName().IsNone())
+			{
+				CustomOutputNodes.FindOrAdd(CustomOutput->GetEventName()).Emplace(NodeIndex);
+			}
+		}
+
+		// prefer the first Start node connected to anything
+		if (DefaultEntryNode == INDEX_NONE && NodeObjects[NodeIndex]->IsA<UFlowNode_Start>())
+		{
+			if (Nodes[NodeIndex].NumSuccessors > 0)
+			{
+				DefaultEntryNode = NodeIndex;
+			}
+			else if (FirstStartNode == INDEX_NONE)
+			{
+				FirstStartNode = NodeIndex;
+			}
+		}
+	}
+
+	if (DefaultEntryNode == INDEX_NONE)
+	{
+		DefaultEntryNode = FirstStartNode;
+	}
+
+	// iterative equivalent of the recursive UFlowAsset::GetNodesInExecutionOrder, successors are pushed in reverse to keep the same order
+	TBitArray<> VisitedNodes;
+	TArray<int32> NodesToVisit;
+
+	for (int32 EntryIndex = 0; EntryIndex < Nodes.Num(); EntryIndex++)
+	{
+		if (Nodes[EntryIndex].NumInputPins > 0)
+		{
+			continue;
+		}
+
+		TArray<int32>& ExecutionOrder = ExecutionOrders.Add(EntryIndex);
+		VisitedNodes.Init(false, Nodes.Num());
+		NodesToVisit.Emplace(EntryIndex);
+
+		while (NodesToVisit.Num() > 0)
+		{
+			const int32 NodeIndex = NodesToVisit.Pop(false);
+			if (VisitedNodes[NodeIndex])
+			{
+				continue;
+			}
+
+			VisitedNodes[NodeIndex] = true;
+			ExecutionOrder.Emplace(NodeIndex);
+
+			const TConstArrayView<int32> NodeSuccessors = GetSuccessors(NodeIndex);
+			for (int32 Index = NodeSuccessors.Num() - 1; Index >= 0; Index--)
+			{
+				if (!VisitedNodes[NodeSuccessors[Index]])
+				{
+					NodesToVisit.Emplace(NodeSuccessors[Index]);
+				}
+			}
+		}
+
+		ExecutionOrder.Shrink();
+	}
+}
+
+void FFlowCompiledGraph::Optimize(const TArray<const UFlowNode*>& NodeObjects)
+{
+	// output connection of every node that simply passes the signal further
+	TArray<int32> FoldedOutputs;
+	FoldedOutputs.Init(INDEX_NONE, Nodes.Num());
+
+	for (int32 NodeIndex = 0; NodeIndex < Nodes.Num(); NodeIndex++)
+	{
+		const FFlowCompiledNode& CompiledNode = Nodes[NodeIndex];
+		if (CompiledNode.NumInputPins == 0 || !CanFoldNode(NodeObjects[NodeIndex]))
+		{
+			continue;
+		}
+
+		// signal has to leave the node through exactly one connected output
+		int32 ConnectedOutput = INDEX_NONE;
+		int32 NumConnectedOutputs = 0;
+		for (int32 PinIndex = CompiledNode.FirstOutputPin; PinIndex < CompiledNode.FirstOutputPin + CompiledNode.NumOutputPins; PinIndex++)
+		{
+			if (OutputConnections[PinIndex].IsConnected())
+			{
+				ConnectedOutput = PinIndex;
+				NumConnectedOutputs++;
+			}
+		}
+
+		if (NumConnectedOutputs == 1)
+		{
+			FoldedOutputs[NodeIndex] = ConnectedOutput;
+		}
+	}
+
+	// splice folded nodes out of connections, chains of reroutes are collapsed into a single hop
+	for (FFlowCompiledConnection& Connection : OutputConnections)
+	{
+		FFlowCompiledConnection Spliced = Connection;
+		int32 Hops = 0;
+
+		while (Spliced.IsConnected() && FoldedOutputs[Spliced.NodeIndex] != INDEX_NONE && Hops <= Nodes.Num())
+		{
+			Spliced = OutputConnections[FoldedOutputs[Spliced.NodeIndex]];
+			Hops++;
+		}
+
+		// loop made only of folded nodes, leave it as it is
+		if (Hops <= Nodes.Num())
+		{
+			Connection = Spliced;
+		}
+	}
+
+	// mark nodes reachable from entry nodes, every node without input pins can start the graph execution
+	TArray<int32> NodesToVisit;
+	for (int32 NodeIndex = 0; NodeIndex < Nodes.Num(); NodeIndex++)
+	{
+		Nodes[NodeIndex].bReachable = Nodes[NodeIndex].NumInputPins == 0;
+		if (Nodes[NodeIndex].bReachable)
+		{
+			NodesToVisit.Emplace(NodeIndex);
+		}
+	}
+
+	while (NodesToVisit.Num() > 0)
+	{
+		const FFlowCompiledNode& CompiledNode = Nodes[NodesToVisit.Pop(false)];
+		for (int32 PinIndex = CompiledNode.FirstOutputPin; PinIndex < CompiledNode.FirstOutputPin + CompiledNode.NumOutputPins; PinIndex++)
+		{
+			const FFlowCompiledConnection& Connection = OutputConnections[PinIndex];
+			if (Connection.IsConnected() && !Nodes[Connection.NodeIndex].bReachable)
+			{
+				Nodes[Connection.NodeIndex].bReachable = true;
+				NodesToVisit.Emplace(Connection.NodeIndex);
+			}
+		}
+	}
+
+	for (int32 NodeIndex = 0; NodeIndex < Nodes.Num(); NodeIndex++)
+	{
+		Nodes[NodeIndex].bFolded = FoldedOutputs[NodeIndex] != INDEX_NONE && !Nodes[NodeIndex].bReachable;
+		NumFoldedNodes += Nodes[NodeIndex].bFolded ? 1 : 0;
+		NumUnreachableNodes += Nodes[NodeIndex].bReachable ? 0 : 1;
+	}
+}
+
+bool FFlowCompiledGraph::CanFoldNode(const UFlowNode* Node)
+{
+	if (Node->CanFinishGraph() || Node->GetFlowNodeAddOnChildren().Num() > 0)
+	{
+		return false;
+	}
+
+	switch (Node->GetSignalMode())
+	{
+		case EFlowSignalMode::Enabled:
+			return Node->IsA<UFlowNode_Reroute>();
+		case EFlowSignalMode::PassThrough:
+			return Node->HasDefaultPassThrough();
+		default:
+			return false;
+	}
+}
+
+void FFlowCompiledGraph::Reset()
+{
+	DefaultEntryNode = INDEX_NONE;
+	NumFoldedNodes = 0;
+	NumUnreachableNodes = 0;
+
+	Nodes.Reset();
+	InputPinNames.Reset();
+	OutputPinNames.Reset();
+	OutputConnections.Reset();
+	ConnectedInputPins.Empty();
+	Successors.Reset();
+	Predecessors.Reset();
+	NodeIndices.Reset();
+	NodesByClass.Reset();
+	CustomInputNodes.Reset();
+	CustomOutputNodes.Reset();
+	CustomInputNames.Reset();
+	CustomOutputNames.Reset();
+	ExecutionOrders.Reset();
+}
+
+bool FFlowCompiledGraph::IsUpToDate(const TMap<FGuid, UFlowNode*>& InNodes) const
+{
+	int32 NumValidNodes = 0;
+
+	for (const TPair<FGuid, UFlowNode*>& Pair : InNodes)
+	{
+		const UFlowNode* Node = Pair.Value;
+		if (Node == nullptr)
+		{
+			continue;
+		}
+		NumValidNodes++;
+
+		const int32 NodeIndex = FindNodeIndex(Pair.Key);
+		if (NodeIndex == INDEX_NONE)
+		{
+			return false;
+		}
+
+		const FFlowCompiledNode& CompiledNode = Nodes[NodeIndex];
+		if (CompiledNode.NumInputPins != Node->GetInputPins().Num() || CompiledNode.NumOutputPins != Node->GetOutputPins().Num())
+		{
+			return false;
+		}
+
+		for (int32 PinIndex = 0; PinIndex < CompiledNode.NumInputPins; PinIndex++)
+		{
+			if (InputPinNames[CompiledNode.FirstInputPin + PinIndex] != Node->GetInputPins()[PinIndex].PinName)
+			{
+				return false;
+			}
+		}
+
+		for (int32 PinIndex = 0; PinIndex < CompiledNode.NumOutputPins; PinIndex++)
+		{
+			if (OutputPinNames[CompiledNode.FirstOutputPin + PinIndex] != Node->GetOutputPins()[PinIndex].PinName)
+			{
+				return false;
+			}
+		}
+
+		// event names can be changed without changing pins
+		if (const UFlowNode_CustomEventBase* CustomEvent = Cast<UFlowNode_CustomEventBase>(Node))
+		{
+			const TMap<FName, TArray<int32>>& EventNodes = Node->IsA<UFlowNode_CustomInput>() ? CustomInputNodes : CustomOutputNodes;
+			const TArray<int32>* FoundNodes = EventNodes.Find(CustomEvent->GetEventName());
+			if (!CustomEvent->GetEventName().IsNone() && (FoundNodes == nullptr || !FoundNodes->Contains(NodeIndex)))
+			{
+				return false;
+			}
+		}
+	}
+
+	return NumValidNodes == Nodes.Num();
+}
+
+int32 FFlowCompiledGraph::FindNodeIndex(const FGuid& NodeGuid) const
+{
+	const int32* FoundIndex = NodeIndices.Find(NodeGuid);
+	return FoundIndex ? *FoundIndex : INDEX_NONE;
+}
+
+const FFlowCompiledConnection* FFlowCompiledGraph::FindConnection(const int32 NodeIndex, const int32 OutputPinIndex) const
+{
+	if (Nodes.IsValidIndex(NodeIndex))
+	{
+		const FFlowCompiledNode& CompiledNode = Nodes[NodeIndex];
+		if (OutputPinIndex >= 0 && OutputPinIndex < CompiledNode.NumOutputPins)
+		{
+			return &OutputConnections[CompiledNode.FirstOutputPin + OutputPinIndex];
+		}
+	}
+
+	return nullptr;
+}
+
+TConstArrayView<int32> FFlowCompiledGraph::GetSuccessors(const int32 NodeIndex) const
+{
+	if (Nodes.IsValidIndex(NodeIndex))
+	{
+		return TConstArrayView<int32>(Successors.GetData() + Nodes[NodeIndex].FirstSuccessor, Nodes[NodeIndex].NumSuccessors);
+	}
+
+	return TConstArrayView<int32>();
+}
+
+TConstArrayView<int32> FFlowCompiledGraph::GetNodesByClass(const UClass* NodeClass) const
+{
+	const TArray<int32>* FoundNodes = NodesByClass.Find(NodeClass);
+	return FoundNodes ? TConstArrayView<int32>(*FoundNodes) : TConstArrayView<int32>();
+}
+
+TConstArrayView<int32> FFlowCompiledGraph::FindCustomInputNodes(const FName& EventName) const
+{
+	const TArray<int32>* FoundNodes = CustomInputNodes.Find(EventName);
+	return FoundNodes ? TConstArrayView<int32>(*FoundNodes) : TConstArrayView<int32>();
+}
+
+TConstArrayView<int32> FFlowCompiledGraph::FindCustomOutputNodes(const FName& EventName) const
+{
+	const TArray<int32>* FoundNodes = CustomOutputNodes.Find(EventName);
+	return FoundNodes ? TConstArrayView<int32>(*FoundNodes) : TConstArrayView<int32>();
+}
+
+TConstArrayView<int32> FFlowCompiledGraph::GetPredecessors(const int32 NodeIndex) const
+{
+	if (Nodes.IsValidIndex(NodeIndex))
+	{
+		return TConstArrayView<int32>(Predecessors.GetData() + Nodes[NodeIndex].FirstPredecessor, Nodes[NodeIndex].NumPredecessors);
+	}
+
+	return TConstArrayView<int32>();
+}
+
+int32 FFlowCompiledGraph::FindInputPinIndex(const int32 NodeIndex, const FName& PinName) const
+{
+	if (Nodes.IsValidIndex(NodeIndex))
+	{
+		const FFlowCompiledNode& CompiledNode = Nodes[NodeIndex];
+		for (int32 PinIndex = 0; PinIndex < CompiledNode.NumInputPins; PinIndex++)
+		{
+			if (InputPinNames[CompiledNode.FirstInputPin + PinIndex] == PinName)
+			{
+				return PinIndex;
+			}
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+bool FFlowCompiledGraph::IsInputConnected(const int32 NodeIndex, const FName& PinName) const
+{
+	const int32 PinIndex = FindInputPinIndex(NodeIndex, PinName);
+	return PinIndex != INDEX_NONE && ConnectedInputPins[Nodes[NodeIndex].FirstInputPin + PinIndex];
+}
@@ -0,0 +1,149 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Types/FlowPreloadBudget.h"
+#include "Nodes/FlowNode.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(FlowPreloadBudget)
+
+void FFlowPreloadList::Add(UFlowNode* Node)
+{
+	Remove(Node);
+
+	const FFlowPreloadEntry Entry(Node, Node->GetPreloadedAsset(), Node->EstimatePreloadedMemory());
+	AddAssetUser(Entry);
+
+	if (Entry.EstimatedSize == 0)
+	{
+		PendingNodes.Add(TObjectKey<UFlowNode>(Node));
+	}
+
+	Entries.AddTail(Entry);
+	EntriesByNode.Add(TObjectKey<UFlowNode>(Node), Entries.GetTail());
+}
+
+void FFlowPreloadList::Remove(const UFlowNode* Node)
+{
+	if (FEntryNode* EntryNode = EntriesByNode.FindRef(TObjectKey<UFlowNode>(Node)))
+	{
+		RemoveEntry(EntryNode);
+	}
+}
+
+void FFlowPreloadList::Touch(const UFlowNode* Node)
+{
+	FEntryNode* EntryNode = EntriesByNode.FindRef(TObjectKey<UFlowNode>(Node));
+	if (EntryNode && EntryNode != Entries.GetTail())
+	{
+		Entries.RemoveNode(EntryNode, false);
+		Entries.AddTail(EntryNode);
+	}
+}
+
+void FFlowPreloadList::MeasurePendingEntries()
+{
+	for (TSet<TObjectKey<UFlowNode>>::TIterator It(PendingNodes); It; ++It)
+	{
+		FFlowPreloadEntry& Entry = EntriesByNode.FindChecked(*It)->GetValue();
+		UFlowNode* Node = Entry.Node.ResolveObjectPtr();
+		const int64 EstimatedSize = Node ? Node->EstimatePreloadedMemory() : 0;
+
+		if (EstimatedSize > 0)
+		{
+			RemoveAssetUser(Entry);
+			Entry.Asset = FObjectKey(Node->GetPreloadedAsset());
+			Entry.EstimatedSize = EstimatedSize;
+			AddAssetUser(Entry);
+
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void FFlowPreloadList::RemoveLeastRecentlyUsed(const int64 BudgetBytes, const UFlowNode* ProtectedNode, TArray<UFlowNode*>& OutRemovedNodes)
+{
+	// walking the whole list happens only while preloads exceed the budget
+	TSet<FObjectKey> PinnedAssets;
+	for (FEntryNode* EntryNode = Entries.GetHead(); EntryNode; EntryNode = EntryNode->GetNextNode())
+	{
+		const FFlowPreloadEntry& Entry = EntryNode->GetValue();
+		const UFlowNode* Node = Entry.Node.ResolveObjectPtr();
+
+		if (Node && Entry.Asset != FObjectKey() && (Node == ProtectedNode || Node->GetActivationState() == EFlowNodeState::Active))
+		{
+			PinnedAssets.Add(Entry.Asset);
+		}
+	}
+
+	for (FEntryNode* EntryNode = Entries.GetHead(); EntryNode && EstimatedBytes > BudgetBytes;)
+	{
+		FEntryNode* NextEntryNode = EntryNode->GetNextNode();
+		const FFlowPreloadEntry& Entry = EntryNode->GetValue();
+		UFlowNode* Node = Entry.Node.ResolveObjectPtr();
+
+		if (Node == nullptr)
+		{
+			// node destroyed without flushing its content
+			RemoveEntry(EntryNode);
+		}
+		else if (Node != ProtectedNode && Entry.EstimatedSize > 0 && Node->GetActivationState() != EFlowNodeState::Active && !PinnedAssets.Contains(Entry.Asset))
+		{
+			OutRemovedNodes.Add(Node);
+			RemoveEntry(EntryNode);
+		}
+
+		EntryNode = NextEntryNode;
+	}
+}
+
+void FFlowPreloadList::Empty()
+{
+	Entries.Empty();
+	EntriesByNode.Empty();
+	Assets.Empty();
+	PendingNodes.Empty();
+	EstimatedBytes = 0;
+}
+
+void FFlowPreloadList::RemoveEntry(FEntryNode* EntryNode)
+{
+	const FFlowPreloadEntry& Entry = EntryNode->GetValue();
+	RemoveAssetUser(Entry);
+
+	EntriesByNode.Remove(Entry.Node);
+	PendingNodes.Remove(Entry.Node);
+	Entries.RemoveNode(EntryNode);
+}
+
+void FFlowPreloadList::AddAssetUser(const FFlowPreloadEntry& Entry)
+{
+	if (Entry.Asset == FObjectKey())
+	{
+		EstimatedBytes += Entry.EstimatedSize;
+		return;
+	}
+
+	// asset is counted with the first non-zero estimate
+	FPreloadedAsset& Asset = Assets.FindOrAdd(Entry.Asset);
+	Asset.Users++;
+	if (Asset.EstimatedSize == 0)
+	{
+		Asset.EstimatedSize = Entry.EstimatedSize;
+		EstimatedBytes += Entry.EstimatedSize;
+	}
+}
+
+void FFlowPreloadList::RemoveAssetUser(const FFlowPreloadEntry& Entry)
+{
+	if (Entry.Asset == FObjectKey())
+	{
+		EstimatedBytes -= Entry.EstimatedSize;
+		return;
+	}
+
+	FPreloadedAsset* Asset = Assets.Find(Entry.Asset);
+	if (Asset && --Asset->Users == 0)
+	{
+		EstimatedBytes -= Asset->EstimatedSize;
+		Assets.Remove(Entry.Asset);
+	}
+}
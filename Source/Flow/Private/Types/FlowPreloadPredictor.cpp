@@ -0,0 +1,121 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Types/FlowPreloadPredictor.h"
+
+void FFlowPreloadPredictor::Initialize(const int32 InDistance, const int32 InMaxNodes, const int32 NumNodes)
+{
+	Distance = InDistance;
+	MaxNodes = InMaxNodes;
+
+	PreloadedBits.Init(false, NumNodes);
+	WindowBits.Init(false, NumNodes);
+	WindowNodes.Reset();
+
+	EnteredNodes.Reset();
+	LeftNodes.Reset();
+}
+
+void FFlowPreloadPredictor::Reset()
+{
+	Initialize(Distance, MaxNodes, WindowBits.Num());
+}
+
+void FFlowPreloadPredictor::Update(const FFlowCompiledGraph& Graph, const TBitArray<>& ActiveNodes)
+{
+	EnteredNodes.Reset();
+	LeftNodes.Reset();
+
+	const int32 NumNodes = Graph.Num();
+	NewWindowBits.Init(false, NumNodes);
+	NewWindowNodes.Reset();
+	VisitedBits.Init(false, NumNodes);
+	Frontier.Reset();
+
+	for (TConstSetBitIterator<> It(ActiveNodes); It; ++It)
+	{
+		const int32 NodeIndex = It.GetIndex();
+		if (NodeIndex < NumNodes)
+		{
+			NewWindowBits[NodeIndex] = true;
+			NewWindowNodes.Add(NodeIndex);
+			VisitedBits[NodeIndex] = true;
+			Frontier.Add(NodeIndex);
+		}
+	}
+
+	int32 NumPredictedNodes = 0;
+	bool bLimitReached = false;
+
+	for (int32 CurrentDistance = 1; CurrentDistance <= Distance && Frontier.Num() > 0 && !bLimitReached; CurrentDistance++)
+	{
+		NextFrontier.Reset();
+
+		for (const int32 NodeIndex : Frontier)
+		{
+			PendingNodes.Reset();
+			PendingNodes.Add(NodeIndex);
+
+			while (PendingNodes.Num() > 0 && !bLimitReached)
+			{
+				for (const int32 Successor : Graph.GetSuccessors(PendingNodes.Pop(false)))
+				{
+					if (VisitedBits[Successor])
+					{
+						continue;
+					}
+
+					// folded nodes are never executed, so they aren't preloaded, but nodes behind them are at the same distance
+					if (Graph.IsFolded(Successor))
+					{
+						VisitedBits[Successor] = true;
+						PendingNodes.Add(Successor);
+						continue;
+					}
+
+					if (!Graph.IsReachable(Successor))
+					{
+						continue;
+					}
+
+					if (MaxNodes > 0 && NumPredictedNodes >= MaxNodes)
+					{
+						bLimitReached = true;
+						break;
+					}
+
+					VisitedBits[Successor] = true;
+					NewWindowBits[Successor] = true;
+					NewWindowNodes.Add(Successor);
+					NextFrontier.Add(Successor);
+					NumPredictedNodes++;
+				}
+			}
+
+			if (bLimitReached)
+			{
+				break;
+			}
+		}
+
+		Swap(Frontier, NextFrontier);
+	}
+
+	for (const int32 NodeIndex : NewWindowNodes)
+	{
+		if (!WindowBits.IsValidIndex(NodeIndex) || !WindowBits[NodeIndex])
+		{
+			EnteredNodes.Add(NodeIndex);
+		}
+	}
+
+	for (const int32 NodeIndex : WindowNodes)
+	{
+		if (!NewWindowBits[NodeIndex])
+		{
+			LeftNodes.Add(NodeIndex);
+		}
+	}
+
+	Swap(WindowBits, NewWindowBits);
+	Swap(WindowNodes, NewWindowNodes);
+}
@@ -0,0 +1,85 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Types/FlowSignalLimiter.h"
+
+#include "Algo/Reverse.h"
+
+void FFlowSignalLimiter::Initialize(const int32 InMaxDepth, const int32 InMaxSignalsPerFrame, const EFlowSignalLimitPolicy InPolicy)
+{
+	MaxDepth = InMaxDepth;
+	MaxSignalsPerFrame = InMaxSignalsPerFrame;
+	Policy = InPolicy;
+
+	Reset();
+}
+
+void FFlowSignalLimiter::Reset()
+{
+	Depth = 0;
+	SignalFrame = 0;
+	SignalsInFrame = 0;
+	LimitExceededFrame = MAX_uint64;
+
+	RecentSignals.Reset();
+	NextRecentSignal = 0;
+}
+
+bool FFlowSignalLimiter::TryAddSignal(const FFlowCompiledConnection& Signal, bool& bOutDepthExceeded)
+{
+	if (SignalFrame != GFrameCounter)
+	{
+		SignalFrame = GFrameCounter;
+		SignalsInFrame = 0;
+	}
+
+	bOutDepthExceeded = MaxDepth > 0 && Depth >= MaxDepth;
+	if (bOutDepthExceeded || (MaxSignalsPerFrame > 0 && SignalsInFrame >= MaxSignalsPerFrame))
+	{
+		return false;
+	}
+
+	SignalsInFrame++;
+
+	if (RecentSignals.Num() < NumRecentSignals)
+	{
+		RecentSignals.Add(Signal);
+	}
+	else
+	{
+		RecentSignals[NextRecentSignal] = Signal;
+		NextRecentSignal = (NextRecentSignal + 1) % NumRecentSignals;
+	}
+
+	return true;
+}
+
+bool FFlowSignalLimiter::MarkLimitExceeded()
+{
+	if (HasExceededLimitInFrame())
+	{
+		return false;
+	}
+
+	LimitExceededFrame = GFrameCounter;
+	return true;
+}
+
+void FFlowSignalLimiter::FindLoop(const FFlowCompiledConnection& Signal, TArray<FFlowCompiledConnection>& OutLoop) const
+{
+	OutLoop.Reset();
+
+	// walk back from the newest signal
+	const int32 NumSignals = RecentSignals.Num();
+	for (int32 i = 1; i <= NumSignals; i++)
+	{
+		const FFlowCompiledConnection& RecentSignal = RecentSignals[(NextRecentSignal - i + NumSignals) % NumSignals];
+		OutLoop.Add(RecentSignal);
+
+		if (RecentSignal.NodeIndex == Signal.NodeIndex && RecentSignal.InputPinIndex == Signal.InputPinIndex && RecentSignal.InputPinName == Signal.InputPinName)
+		{
+			break;
+		}
+	}
+
+	Algo::Reverse(OutLoop);
+}
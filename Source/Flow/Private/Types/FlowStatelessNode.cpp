@@ -0,0 +1,43 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Types/FlowStatelessNode.h"
+#include "FlowAsset.h"
+#include "Nodes/FlowNode.h"
+
+FFlowStatelessNodeScope::FFlowStatelessNodeScope(UFlowAsset* InFlowInstance, UFlowNode* InNode)
+	: FlowInstance(InFlowInstance)
+	, Node(InNode)
+	, PreviousInstance(nullptr)
+	, bBound(false)
+{
+	// node might be already executing on behalf of this instance, i.e. signal looped back to it
+	if (FlowInstance && FlowInstance->IsSharedNode(Node) && Node->StatelessExecutionInstance != FlowInstance)
+	{
+		bBound = true;
+
+		PreviousInstance = Node->StatelessExecutionInstance;
+		Node->StatelessExecutionInstance = FlowInstance;
+		SwapState();
+	}
+}
+
+FFlowStatelessNodeScope::~FFlowStatelessNodeScope()
+{
+	if (bBound)
+	{
+		SwapState();
+		Node->StatelessExecutionInstance = PreviousInstance;
+	}
+}
+
+void FFlowStatelessNodeScope::SwapState() const
+{
+	// swapping keeps the state of outer scopes intact, if the same template node executes for another instance in the meantime
+	FFlowStatelessNodeState& State = FlowInstance->StatelessNodeStates.FindOrAdd(Node);
+	Swap(State.ActivationState, Node->ActivationState);
+
+#if !UE_BUILD_SHIPPING
+	Swap(State.InputRecords, Node->InputRecords);
+	Swap(State.OutputRecords, Node->OutputRecords);
+#endif
+}
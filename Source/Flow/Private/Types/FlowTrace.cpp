@@ -0,0 +1,475 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Types/FlowTrace.h"
+#include "FlowAsset.h"
+#include "FlowLogChannels.h"
+#include "Nodes/FlowNode.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+namespace FlowTrace
+{
+	static constexpr uint32 FileMagic = 0x52544c46; // "FLTR"
+	static constexpr int32 FileVersion = 1;
+
+	enum class EChunkType : uint8
+	{
+		Template,
+		Instance,
+		Events
+	};
+
+	static uint64 MakeKey(const uint32 Id, const int32 NodeIndex)
+	{
+		return (static_cast<uint64>(Id) << 32) | static_cast<uint32>(NodeIndex);
+	}
+}
+
+FArchive& operator<<(FArchive& Ar, FFlowTraceEvent& Event)
+{
+	Ar << Event.Time;
+	Ar << Event.Frame;
+	Ar << Event.InstanceId;
+	Ar << Event.TemplateId;
+	Ar << Event.NodeIndex;
+	Ar << Event.PinIndex;
+	Ar << Event.Type;
+	Ar << Event.ActivationType;
+	return Ar;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Recorder
+
+bool FFlowTraceRecorder::bRecording = false;
+
+FFlowTraceRecorder& FFlowTraceRecorder::Get()
+{
+	static FFlowTraceRecorder Recorder;
+	return Recorder;
+}
+
+void FFlowTraceRecorder::Start(const int32 InCapacity, const FString& StreamFilename /* = FString() */)
+{
+	Stop();
+
+	Capacity = FMath::Max(InCapacity, 1);
+	NextEvent = 0;
+	Events.Empty(Capacity);
+	Templates.Empty();
+	Instances.Empty();
+	TemplateIds.Empty();
+	InstanceIds.Empty();
+	NextId = 1;
+
+	if (!StreamFilename.IsEmpty())
+	{
+		StreamArchive = TUniquePtr<FArchive>(IFileManager::Get().CreateFileWriter(*StreamFilename));
+		if (!StreamArchive.IsValid())
+		{
+			UE_LOG(LogFlow, Error, TEXT("Flow Trace couldn't open file %s for streaming"), *StreamFilename);
+			return;
+		}
+
+		uint32 Magic = FlowTrace::FileMagic;
+		int32 Version = FlowTrace::FileVersion;
+		*StreamArchive << Magic;
+		*StreamArchive << Version;
+	}
+
+	bRecording = true;
+	UE_LOG(LogFlow, Log, TEXT("Flow Trace started, %s"), StreamArchive.IsValid() ? *FString::Printf(TEXT("streaming to %s"), *StreamFilename) : *FString::Printf(TEXT("buffer capacity %d"), Capacity));
+}
+
+void FFlowTraceRecorder::Stop()
+{
+	if (StreamArchive.IsValid())
+	{
+		FlushStream();
+		StreamArchive->Close();
+		StreamArchive.Reset();
+	}
+
+	if (bRecording)
+	{
+		bRecording = false;
+		UE_LOG(LogFlow, Log, TEXT("Flow Trace stopped"));
+	}
+}
+
+bool FFlowTraceRecorder::DumpToFile(const FString& Filename) const
+{
+	const TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!Ar.IsValid())
+	{
+		UE_LOG(LogFlow, Error, TEXT("Flow Trace couldn't write file %s"), *Filename);
+		return false;
+	}
+
+	uint32 Magic = FlowTrace::FileMagic;
+	int32 Version = FlowTrace::FileVersion;
+	*Ar << Magic;
+	*Ar << Version;
+
+	for (const TPair<uint32, FFlowTraceTemplateInfo>& Template : Templates)
+	{
+		FFlowTraceTemplateInfo Info = Template.Value;
+		WriteTemplate(*Ar, Template.Key, Info);
+	}
+
+	for (const TPair<uint32, FFlowTraceInstanceInfo>& Instance : Instances)
+	{
+		FFlowTraceInstanceInfo Info = Instance.Value;
+		WriteInstance(*Ar, Instance.Key, Info);
+	}
+
+	// ring buffer starts from the oldest event
+	TArray<FFlowTraceEvent> OrderedEvents;
+	OrderedEvents.Reserve(Events.Num());
+	for (int32 i = 0; i < Events.Num(); i++)
+	{
+		OrderedEvents.Add(Events[(NextEvent + i) % Events.Num()]);
+	}
+	WriteEvents(*Ar, OrderedEvents);
+
+	UE_LOG(LogFlow, Log, TEXT("Flow Trace written %d events to %s"), OrderedEvents.Num(), *Filename);
+	return Ar->Close();
+}
+
+FString FFlowTraceRecorder::GetDefaultFilename()
+{
+	return FPaths::ProfilingDir() / TEXT("Flow") / FString::Printf(TEXT("FlowTrace-%s.flowtrace"), *FDateTime::Now().ToString());
+}
+
+void FFlowTraceRecorder::RecordSignal(const UFlowNode* Node, const EFlowTraceEventType Type, const int32 PinIndex, const EFlowPinActivationType ActivationType)
+{
+	const UFlowAsset* FlowInstance = Node->GetFlowAsset();
+	if (FlowInstance == nullptr)
+	{
+		return;
+	}
+
+	const uint32* FoundInstanceId = InstanceIds.Find(FlowInstance);
+	const uint32 InstanceId = FoundInstanceId ? *FoundInstanceId : RegisterInstance(FlowInstance);
+	const FFlowTraceInstanceInfo* InstanceInfo = &Instances.FindChecked(InstanceId);
+
+	FFlowTraceEvent Event;
+	Event.Time = FPlatformTime::Seconds();
+	Event.Frame = GFrameCounter;
+	Event.InstanceId = InstanceId;
+	Event.TemplateId = InstanceInfo->TemplateId;
+	Event.NodeIndex = Node->GetCompiledIndex();
+	Event.PinIndex = static_cast<int16>(PinIndex);
+	Event.Type = Type;
+	Event.ActivationType = ActivationType;
+
+	if (Events.Num() < Capacity)
+	{
+		Events.Add(Event);
+		NextEvent = Events.Num() % Capacity;
+
+		if (StreamArchive.IsValid() && Events.Num() == Capacity)
+		{
+			FlushStream();
+		}
+	}
+	else
+	{
+		Events[NextEvent] = Event;
+		NextEvent = (NextEvent + 1) % Capacity;
+	}
+}
+
+uint32 FFlowTraceRecorder::RegisterInstance(const UFlowAsset* FlowInstance)
+{
+	const UFlowAsset* Template = FlowInstance->GetTemplateAsset() ? FlowInstance->GetTemplateAsset() : FlowInstance;
+
+	uint32 TemplateId = 0;
+	if (const uint32* FoundTemplateId = TemplateIds.Find(Template))
+	{
+		TemplateId = *FoundTemplateId;
+	}
+	else
+	{
+		TemplateId = NextId++;
+		TemplateIds.Add(Template, TemplateId);
+
+		FFlowTraceTemplateInfo& TemplateInfo = Templates.Add(TemplateId);
+		TemplateInfo.AssetPath = Template->GetPathName();
+
+		if (const FFlowCompiledGraph* CompiledGraph = Template->FindCompiledGraph())
+		{
+			TemplateInfo.NodeNames.Reserve(CompiledGraph->Num());
+			for (int32 NodeIndex = 0; NodeIndex < CompiledGraph->Num(); NodeIndex++)
+			{
+				const UFlowNode* TemplateNode = Template->GetNodeByIndex(NodeIndex);
+				TemplateInfo.NodeNames.Add(TemplateNode ? TemplateNode->GetName() : CompiledGraph->Nodes[NodeIndex].NodeGuid.ToString());
+			}
+		}
+
+		if (StreamArchive.IsValid())
+		{
+			WriteTemplate(*StreamArchive, TemplateId, TemplateInfo);
+		}
+	}
+
+	const uint32 InstanceId = NextId++;
+	InstanceIds.Add(FlowInstance, InstanceId);
+
+	FFlowTraceInstanceInfo& InstanceInfo = Instances.Add(InstanceId);
+	InstanceInfo.TemplateId = TemplateId;
+	InstanceInfo.InstanceName = FlowInstance->GetName();
+
+	if (StreamArchive.IsValid())
+	{
+		WriteInstance(*StreamArchive, InstanceId, InstanceInfo);
+	}
+
+	return InstanceId;
+}
+
+void FFlowTraceRecorder::FlushStream()
+{
+	if (Events.Num() > 0)
+	{
+		WriteEvents(*StreamArchive, Events);
+		Events.Reset();
+		NextEvent = 0;
+	}
+}
+
+void FFlowTraceRecorder::WriteTemplate(FArchive& Ar, const uint32 TemplateId, FFlowTraceTemplateInfo& Info) const
+{
+	FlowTrace::EChunkType ChunkType = FlowTrace::EChunkType::Template;
+	uint32 Id = TemplateId;
+
+	Ar << ChunkType;
+	Ar << Id;
+	Ar << Info.AssetPath;
+	Ar << Info.NodeNames;
+}
+
+void FFlowTraceRecorder::WriteInstance(FArchive& Ar, const uint32 InstanceId, FFlowTraceInstanceInfo& Info) const
+{
+	FlowTrace::EChunkType ChunkType = FlowTrace::EChunkType::Instance;
+	uint32 Id = InstanceId;
+
+	Ar << ChunkType;
+	Ar << Id;
+	Ar << Info.TemplateId;
+	Ar << Info.InstanceName;
+}
+
+void FFlowTraceRecorder::WriteEvents(FArchive& Ar, TArray<FFlowTraceEvent>& InEvents) const
+{
+	FlowTrace::EChunkType ChunkType = FlowTrace::EChunkType::Events;
+
+	Ar << ChunkType;
+	Ar << InEvents;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Reader
+
+bool FFlowTraceReader::LoadFromFile(const FString& Filename)
+{
+	Events.Empty();
+	Templates.Empty();
+	Instances.Empty();
+
+	const TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileReader(*Filename));
+	if (!Ar.IsValid())
+	{
+		UE_LOG(LogFlow, Error, TEXT("Flow Trace couldn't open file %s"), *Filename);
+		return false;
+	}
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	*Ar << Magic;
+	*Ar << Version;
+
+	if (Magic != FlowTrace::FileMagic || Version > FlowTrace::FileVersion)
+	{
+		UE_LOG(LogFlow, Error, TEXT("File %s isn't a supported Flow Trace"), *Filename);
+		return false;
+	}
+
+	while (!Ar->AtEnd() && !Ar->IsError())
+	{
+		FlowTrace::EChunkType ChunkType;
+		*Ar << ChunkType;
+
+		switch (ChunkType)
+		{
+			case FlowTrace::EChunkType::Template:
+			{
+				uint32 Id = 0;
+				FFlowTraceTemplateInfo Info;
+				*Ar << Id;
+				*Ar << Info.AssetPath;
+				*Ar << Info.NodeNames;
+				Templates.Emplace(Id, MoveTemp(Info));
+				break;
+			}
+			case FlowTrace::EChunkType::Instance:
+			{
+				uint32 Id = 0;
+				FFlowTraceInstanceInfo Info;
+				*Ar << Id;
+				*Ar << Info.TemplateId;
+				*Ar << Info.InstanceName;
+				Instances.Emplace(Id, MoveTemp(Info));
+				break;
+			}
+			case FlowTrace::EChunkType::Events:
+			{
+				TArray<FFlowTraceEvent> ChunkEvents;
+				*Ar << ChunkEvents;
+				Events.Append(MoveTemp(ChunkEvents));
+				break;
+			}
+			default:
+				UE_LOG(LogFlow, Error, TEXT("Flow Trace %s is corrupted"), *Filename);
+				return false;
+		}
+	}
+
+	return !Ar->IsError();
+}
+
+FString FFlowTraceReader::DescribeNode(const uint32 TemplateId, const int32 NodeIndex) const
+{
+	if (const FFlowTraceTemplateInfo* Template = Templates.Find(TemplateId))
+	{
+		const FString NodeName = Template->NodeNames.IsValidIndex(NodeIndex) ? Template->NodeNames[NodeIndex] : FString::FromInt(NodeIndex);
+		return FString::Printf(TEXT("%s.%s"), *FPaths::GetBaseFilename(Template->AssetPath), *NodeName);
+	}
+
+	return FString::Printf(TEXT("%u.%d"), TemplateId, NodeIndex);
+}
+
+void FFlowTraceReader::BuildReport(FFlowTraceReport& OutReport) const
+{
+	OutReport = FFlowTraceReport();
+	if (Events.Num() == 0)
+	{
+		return;
+	}
+
+	OutReport.Duration = Events.Last().Time - Events[0].Time;
+	OutReport.NumFrames = Events.Last().Frame - Events[0].Frame + 1;
+
+	TMap<uint64, int32> NodeStatsIndices;
+	TMap<TTuple<uint32, int32, int32>, int32> PathStatsIndices;
+
+	// per instance and node, time of the input activation waiting for the output
+	TMap<uint64, double> PendingInputs;
+
+	// per instance, node whose output has been triggered most recently
+	TMap<uint32, int32> LastOutputNodes;
+
+	for (const FFlowTraceEvent& Event : Events)
+	{
+		const uint64 NodeKey = FlowTrace::MakeKey(Event.TemplateId, Event.NodeIndex);
+		const uint64 InstanceNodeKey = FlowTrace::MakeKey(Event.InstanceId, Event.NodeIndex);
+
+		int32* NodeStatsIndex = NodeStatsIndices.Find(NodeKey);
+		if (NodeStatsIndex == nullptr)
+		{
+			FFlowTraceNodeStats& NewStats = OutReport.Nodes.AddDefaulted_GetRef();
+			NewStats.TemplateId = Event.TemplateId;
+			NewStats.NodeIndex = Event.NodeIndex;
+			NodeStatsIndex = &NodeStatsIndices.Add(NodeKey, OutReport.Nodes.Num() - 1);
+		}
+		FFlowTraceNodeStats& NodeStats = OutReport.Nodes[*NodeStatsIndex];
+
+		if (Event.Type == EFlowTraceEventType::Input)
+		{
+			NodeStats.NumInputs++;
+			PendingInputs.FindOrAdd(InstanceNodeKey, Event.Time);
+
+			int32 FromNodeIndex = INDEX_NONE;
+			if (LastOutputNodes.RemoveAndCopyValue(Event.InstanceId, FromNodeIndex))
+			{
+				const TTuple<uint32, int32, int32> PathKey(Event.TemplateId, FromNodeIndex, Event.NodeIndex);
+				if (const int32* PathStatsIndex = PathStatsIndices.Find(PathKey))
+				{
+					OutReport.HotPaths[*PathStatsIndex].Count++;
+				}
+				else
+				{
+					FFlowTracePathStats& NewPath = OutReport.HotPaths.AddDefaulted_GetRef();
+					NewPath.TemplateId = Event.TemplateId;
+					NewPath.FromNodeIndex = FromNodeIndex;
+					NewPath.ToNodeIndex = Event.NodeIndex;
+					NewPath.Count = 1;
+					PathStatsIndices.Add(PathKey, OutReport.HotPaths.Num() - 1);
+				}
+			}
+		}
+		else
+		{
+			NodeStats.NumOutputs++;
+			LastOutputNodes.Add(Event.InstanceId, Event.NodeIndex);
+
+			double InputTime = 0.0;
+			if (PendingInputs.RemoveAndCopyValue(InstanceNodeKey, InputTime))
+			{
+				const double Latency = Event.Time - InputTime;
+				NodeStats.TotalLatency += Latency;
+				NodeStats.MaxLatency = FMath::Max(NodeStats.MaxLatency, Latency);
+				NodeStats.NumLatencySamples++;
+			}
+		}
+	}
+
+	OutReport.Nodes.Sort([](const FFlowTraceNodeStats& A, const FFlowTraceNodeStats& B)
+	{
+		return A.NumInputs > B.NumInputs;
+	});
+
+	OutReport.HotPaths.Sort([](const FFlowTracePathStats& A, const FFlowTracePathStats& B)
+	{
+		return A.Count > B.Count;
+	});
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Console commands
+
+static FAutoConsoleCommand FlowTraceStartCommand(
+	TEXT("Flow.Trace.Start"),
+	TEXT("Starts recording Flow signals to the ring buffer. Optional argument: buffer capacity"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 Capacity = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : FFlowTraceRecorder::DefaultCapacity;
+		FFlowTraceRecorder::Get().Start(Capacity > 0 ? Capacity : FFlowTraceRecorder::DefaultCapacity);
+	}));
+
+static FAutoConsoleCommand FlowTraceStreamCommand(
+	TEXT("Flow.Trace.Stream"),
+	TEXT("Starts recording Flow signals, streamed to file until recording stops. Optional argument: file name"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		FFlowTraceRecorder::Get().Start(FFlowTraceRecorder::DefaultCapacity, Args.Num() > 0 ? Args[0] : FFlowTraceRecorder::GetDefaultFilename());
+	}));
+
+static FAutoConsoleCommand FlowTraceStopCommand(
+	TEXT("Flow.Trace.Stop"),
+	TEXT("Stops recording Flow signals"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FFlowTraceRecorder::Get().Stop();
+	}));
+
+static FAutoConsoleCommand FlowTraceDumpCommand(
+	TEXT("Flow.Trace.Dump"),
+	TEXT("Writes recorded Flow signals to file. Optional argument: file name"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		FFlowTraceRecorder::Get().DumpToFile(Args.Num() > 0 ? Args[0] : FFlowTraceRecorder::GetDefaultFilename());
+	}));
@@ -5,6 +5,10 @@
 #include "FlowSave.h"
 #include "FlowTypes.h"
 #include "Nodes/FlowNode.h"
+#include "Types/FlowCompiledGraph.h"
+#include "Types/FlowPreloadPredictor.h"
+#include "Types/FlowSignalLimiter.h"
+#include "Types/FlowStatelessNode.h"
 
 #if WITH_EDITOR
 #include "FlowMessageLog.h"
@@ -57,6 +61,8 @@ public:
 	friend class FFlowNode_SubGraphDetails;
 	friend class UFlowGraphSchema;
 
+	friend struct FFlowStatelessNodeScope;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Flow Asset")
 	FGuid AssetGuid;
 
@@ -65,6 +71,42 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flow Asset")
 	bool bWorldBound;
 
+	// Root Flows with higher priority are started first, if Flow Subsystem has to spread starting flows over multiple frames
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flow Asset")
+	int32 StartPriority;
+
+	// If enabled, asset instance creates node objects only when node is triggered or preloaded
+	// Until then, instance points to the template node, which saves memory in large graphs mostly left unvisited
+	// Project-specific code should access node instances via GetNodeInstance() to ensure the node is instantiated
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flow Asset")
+	bool bInstantiateNodesOnDemand;
+
+	// Number of finished instances kept by Flow Subsystem for reuse, useful for short-lived graphs started many times
+	// Reused instance keeps its node instances, so instances are pooled only if all nodes are reusable (see UFlowNode::IsReusable)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flow Asset", meta = (ClampMin = 0))
+	int32 InstancePoolSize;
+
+	// Number of instances created in advance, when Flow Subsystem creates the first instance of this asset
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flow Asset", meta = (ClampMin = 0, EditCondition = "InstancePoolSize > 0"))
+	int32 InstancePoolWarmup;
+
+	// If above 0, asset instance preloads nodes reachable within this number of connections from active nodes, and flushes nodes that fall out of this range
+	// Content like level sequences or SubGraphs is loaded before the graph reaches it
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flow Asset", meta = (ClampMin = 0))
+	int32 PreloadDistance;
+
+	// Maximum number of nodes preloaded ahead of active nodes, the nearest nodes are preloaded first. Zero means no limit
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flow Asset", meta = (ClampMin = 0, EditCondition = "PreloadDistance > 0"))
+	int32 MaxPredictivePreloads;
+
+	// Number of the latest activations recorded per pin in non-shipping builds, displayed by the editor debugger. Zero disables recording
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flow Asset", meta = (ClampMin = 0))
+	int32 PinRecordCapacity;
+
+	// UObject
+	virtual void PostLoad() override;
+	// --
+
 //////////////////////////////////////////////////////////////////////////
 // Graph
 
@@ -76,7 +118,6 @@ public:
 	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 	virtual void PostDuplicate(bool bDuplicateForPIE) override;
-	virtual void PostLoad() override;
 	// --
 
 public:
@@ -190,12 +231,53 @@ public:
 
 		if (FirstIteratedNode)
 		{
-			TSet<TObjectKey<UFlowNode>> IteratedNodes;
-			GetNodesInExecutionOrder_Recursive(FirstIteratedNode, IteratedNodes, OutNodes);
+			if (CompiledGraph.IsValid() && FirstIteratedNode->GetCompiledGraph() == CompiledGraph.Get())
+			{
+				// order from entry nodes is precomputed by the template
+				if (const TArray<int32>* ExecutionOrder = CompiledGraph->FindExecutionOrder(FirstIteratedNode->GetCompiledIndex()))
+				{
+					for (const int32 NodeIndex : *ExecutionOrder)
+					{
+						if (T* NodeOfRequiredType = Cast<T>(IndexedNodes[NodeIndex]))
+						{
+							OutNodes.Emplace(NodeOfRequiredType);
+						}
+					}
+					return;
+				}
+
+				TBitArray<> IteratedNodes(false, CompiledGraph->Num());
+				GetNodesInExecutionOrder_Indexed(FirstIteratedNode->GetCompiledIndex(), IteratedNodes, OutNodes);
+			}
+			else
+			{
+				TSet<TObjectKey<UFlowNode>> IteratedNodes;
+				GetNodesInExecutionOrder_Recursive(FirstIteratedNode, IteratedNodes, OutNodes);
+			}
 		}
 	}
 
 protected:
+	// Walks adjacency of the compiled graph, without allocating sets of connected nodes
+	template <class T>
+	void GetNodesInExecutionOrder_Indexed(const int32 NodeIndex, TBitArray<>& IteratedNodes, TArray<T*>& OutNodes)
+	{
+		IteratedNodes[NodeIndex] = true;
+
+		if (T* NodeOfRequiredType = Cast<T>(IndexedNodes[NodeIndex]))
+		{
+			OutNodes.Emplace(NodeOfRequiredType);
+		}
+
+		for (const int32 ConnectedIndex : CompiledGraph->GetSuccessors(NodeIndex))
+		{
+			if (!IteratedNodes[ConnectedIndex] && IndexedNodes[ConnectedIndex])
+			{
+				GetNodesInExecutionOrder_Indexed(ConnectedIndex, IteratedNodes, OutNodes);
+			}
+		}
+	}
+
 	template <class T>
 	void GetNodesInExecutionOrder_Recursive(UFlowNode* Node, TSet<TObjectKey<UFlowNode>>& IteratedNodes, TArray<T*>& OutNodes)
 	{
@@ -234,13 +316,61 @@ protected:
 	void RemoveCustomOutput(const FName& EventName);
 #endif // WITH_EDITOR
 	
+//////////////////////////////////////////////////////////////////////////
+// Compiled graph
+
+private:
+	// Index-based representation of nodes and connections, shared by the template asset with all its instances
+	TSharedPtr<const FFlowCompiledGraph> CompiledGraph;
+
+	// Node instances addressed by the compiled node index
+	TArray<UFlowNode*> IndexedNodes;
+
+public:
+	// Builds the compiled graph, if it's missing or has been invalidated by editing the asset
+	const TSharedPtr<const FFlowCompiledGraph>& GetCompiledGraph();
+	void InvalidateCompiledGraph();
+
+	// Returns compiled graph without building it, nullptr if it's not available
+	const FFlowCompiledGraph* FindCompiledGraph() const { return CompiledGraph.Get(); }
+
+	// Nodes of the exact class, read from the compiled graph if available
+	template <class T>
+	void GetNodesByClass(TArray<T*>& OutNodes) const
+	{
+		static_assert(TPointerIsConvertibleFromTo<T, const UFlowNode>::Value, "'T' template parameter to GetNodesByClass must be derived from UFlowNode");
+
+		if (CompiledGraph.IsValid())
+		{
+			for (const int32 NodeIndex : CompiledGraph->GetNodesByClass(T::StaticClass()))
+			{
+				OutNodes.Emplace(CastChecked<T>(IndexedNodes[NodeIndex]));
+			}
+			return;
+		}
+
+		for (const TPair<FGuid, UFlowNode*>& Node : Nodes)
+		{
+			if (Node.Value && Node.Value->GetClass() == T::StaticClass())
+			{
+				OutNodes.Emplace(CastChecked<T>(Node.Value));
+			}
+		}
+	}
+
+	// Mirrors GetNode, so it returns the template node if this asset instance hasn't instantiated node yet
+	UFlowNode* GetNodeByIndex(const int32 NodeIndex) const { return IndexedNodes.IsValidIndex(NodeIndex) ? IndexedNodes[NodeIndex] : nullptr; }
+
+protected:
+	void CompileGraph();
+
 //////////////////////////////////////////////////////////////////////////
 // Instances of the template asset
 
 private:
 	// Original object holds references to instances
 	UPROPERTY(Transient)
-	TArray<UFlowAsset*> ActiveInstances;
+	TSet<UFlowAsset*> ActiveInstances;
 
 #if WITH_EDITORONLY_DATA
 	TWeakObjectPtr<UFlowAsset> InspectedInstance;
@@ -295,27 +425,73 @@ protected:
 	// Flow Asset instances created by SubGraph nodes placed in the current graph
 	TMap<TWeakObjectPtr<UFlowNode_SubGraph>, TWeakObjectPtr<UFlowAsset>> ActiveSubGraphs;
 
+	// Node lists below aren't UPROPERTY, as Nodes already keep all node instances alive
+	// Garbage collector would only trace the same references again, for every live instance
+
 	// Optional entry points to the graph, similar to blueprint Custom Events
-	UPROPERTY()
 	TSet<UFlowNode_CustomInput*> CustomInputNodes;
 
-	UPROPERTY()
 	TSet<UFlowNode*> PreloadedNodes;
 
+	// Preloads nodes ahead of active nodes, if Preload Distance is set
+	FFlowPreloadPredictor PreloadPredictor;
+
 	// Nodes that have any work left, not marked as Finished yet
-	UPROPERTY()
+	// Finished node is swapped with the last one, so the order of activation isn't preserved
 	TArray<UFlowNode*> ActiveNodes;
 
 	// All nodes active in the past, done their work
-	UPROPERTY()
 	TArray<UFlowNode*> RecordedNodes;
 
+	// Membership of nodes in ActiveNodes and RecordedNodes, addressed by the compiled node index
+	// RecordedNodes array is kept only to preserve the order of activation
+	TBitArray<> ActiveNodeBits;
+	TBitArray<> RecordedNodeBits;
+
+	// Position of the node in ActiveNodes, addressed by the compiled node index
+	TArray<int32> ActiveNodeSlots;
+
 	EFlowFinishPolicy FinishPolicy;
 
+	// Signals waiting to be passed to connected nodes, if Flow Settings enable queueing signals
+	// Works as a stack, so signals triggered by the node are processed before signals queued earlier
+	TArray<FFlowCompiledConnection> SignalQueue;
+
+	bool bQueueSignals;
+	bool bDrainingSignals;
+
+	// Protects against graphs looping synchronously, if Flow Settings set signal limits
+	FFlowSignalLimiter SignalLimiter;
+
+	// Set after exceeding signal limit with the Abort policy, signals are ignored until the flow is started again
+	bool bAbortedBySignalLimit;
+
+	// Stateless template nodes aren't duplicated by instance, if Flow Settings enable sharing them
+	bool bShareStatelessNodes;
+
+	// State of template nodes executed on behalf of this instance
+	TMap<const UFlowNode*, FFlowStatelessNodeState> StatelessNodeStates;
+
 public:
 	virtual void InitializeInstance(const TWeakObjectPtr<UObject> InOwner, UFlowAsset* InTemplateAsset);
 	virtual void DeinitializeInstance();
 
+	// Called on the pooled instance, its node instances already exist
+	virtual void ReinitializeInstance(const TWeakObjectPtr<UObject> InOwner);
+
+	// Prepares finished instance for returning it to the pool
+	// Node instances are reused, so nodes should reset their runtime state in Cleanup()
+	virtual void ResetInstance();
+
+	// True if all nodes reset their runtime state, so finished instances of this template can be reused
+	bool CanPoolInstances() const;
+
+protected:
+	void CreateNodeInstances(UFlowAsset* InTemplateAsset);
+	void InitializeNodeInstances();
+
+public:
+
 	UFlowAsset* GetTemplateAsset() const { return TemplateAsset; }
 
 	// Object that spawned Root Flow instance, i.e. World Settings or Player Controller
@@ -336,6 +512,33 @@ public:
 	// Opportunity to preload content of project-specific nodes
 	virtual void PreloadNodes() {}
 
+	// Returns node instance, creates it first if asset instantiates nodes on demand
+	UFlowNode* GetNodeInstance(const FGuid& NodeGuid);
+	UFlowNode* GetNodeInstanceByIndex(const int32 NodeIndex);
+
+	// Returns false for the template node, not instantiated by this asset instance yet
+	bool IsNodeInstantiated(const UFlowNode* Node) const { return Node && Node->GetOuter() == this; }
+
+	// Returns true for the stateless template node, executed directly by this asset instance
+	bool IsSharedNode(const UFlowNode* Node) const { return TemplateAsset && Node && !IsNodeInstantiated(Node); }
+
+	int32 GetPinRecordCapacity() const { return PinRecordCapacity; }
+
+protected:
+	UFlowNode* InstantiateNode(const FGuid& NodeGuid, UFlowNode*& Node);
+	bool CanShareNode(const FGuid& NodeGuid, const UFlowNode* TemplateNode) const;
+	bool CanShareNode(const int32 NodeIndex, const UFlowNode* TemplateNode) const;
+
+	// Instantiates node if needed, preloads its content and registers it for flushing on finishing the flow
+	UFlowNode* PreloadNode(const FGuid& NodeGuid);
+
+	// Preloads nodes that got within Preload Distance of active nodes, flushes nodes that fell out of it
+	void UpdatePreloadWindow();
+
+public:
+	// Flushes content of the preloaded node before the flow finishes, i.e. if Flow Subsystem exceeded the Preload Budget
+	void FlushPreloadedNode(UFlowNode* Node);
+
 	virtual void PreStartFlow();
 	virtual void StartFlow();
 
@@ -353,9 +556,37 @@ protected:
 
 	void TriggerInput(const FGuid& NodeGuid, const FName& PinName);
 
+	// Passes signal from the output pin to the connected node, using the compiled graph
+	void TriggerConnectedInput(const UFlowNode* FromNode, const int32 OutputPinIndex);
+
+	void QueueSignal(const FFlowCompiledConnection& Signal);
+	void ExecuteSignal(const FFlowCompiledConnection& Signal);
+
+	// Returns false if the signal can't be passed now, because it exceeds signal limits
+	bool CheckSignalLimits(const FFlowCompiledConnection& Signal);
+	void OnSignalLimitExceeded(const FFlowCompiledConnection& Signal, const bool bDepthExceeded);
+
+	FString DescribeSignal(const FFlowCompiledConnection& Signal) const;
+
+public:
+	// Processes queued signals until the queue is empty or the subsystem runs out of the signal budget for this frame
+	void DrainSignalQueue();
+	bool HasQueuedSignals() const { return SignalQueue.Num() > 0; }
+
+protected:
+	void AddActiveNode(UFlowNode* Node);
+	void RecordNode(UFlowNode* Node);
 	void FinishNode(UFlowNode* Node);
 	void ResetNodes();
 
+private:
+	// Falls back to searching the list if node isn't addressed by the compiled graph of this asset
+	bool ContainsNode(const TBitArray<>& NodeBits, const TArray<UFlowNode*>& NodeList, const UFlowNode* Node) const;
+	void SetNodeBit(TBitArray<>& NodeBits, const UFlowNode* Node, const bool bValue) const;
+
+	void SetActiveNodeSlot(const UFlowNode* Node, const int32 Slot);
+	void RemoveActiveNode(UFlowNode* Node);
+
 public:
 	UFlowSubsystem* GetFlowSubsystem() const;
 	FName GetDisplayName() const;
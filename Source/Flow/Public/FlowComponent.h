@@ -191,6 +191,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "RootFlow")
 	bool bAllowMultipleInstances;
 
+	// Added to Start Priority of the Root Flow asset, if Flow Subsystem has to spread starting flows over multiple frames
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "RootFlow")
+	int32 RootFlowPriority;
+
 	UPROPERTY(SaveGame)
 	FString SavedAssetInstanceName;
 	
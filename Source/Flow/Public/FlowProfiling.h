@@ -0,0 +1,86 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+
+class UFlowAsset;
+class UFlowNode;
+
+// Unreal Insights channel for Flow execution, enable it with -trace=cpu,flow
+UE_TRACE_CHANNEL_EXTERN(FlowChannel, FLOW_API);
+
+namespace FlowProfiling
+{
+	FLOW_API FString GetNodeEventName(const TCHAR* Name, const UFlowNode* Node);
+	FLOW_API FString GetAssetEventName(const TCHAR* Name, const UFlowAsset* FlowAsset);
+
+	// Current values of gauges, published to CSV profiler at the end of every frame
+	struct FLOW_API FGauges
+	{
+		int32 InstancedTemplates;
+		int32 LiveInstances;
+		int32 ActiveNodes;
+		int32 RegisteredComponents;
+
+		FGauges()
+			: InstancedTemplates(0)
+			, LiveInstances(0)
+			, ActiveNodes(0)
+			, RegisteredComponents(0)
+		{
+		}
+	};
+
+	extern FLOW_API FGauges Gauges;
+
+	void PublishGauges();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Stats
+
+DECLARE_STATS_GROUP(TEXT("Flow"), STATGROUP_Flow, STATCAT_Advanced);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Instanced Templates"), STAT_FlowInstancedTemplates, STATGROUP_Flow, FLOW_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Live Instances"), STAT_FlowLiveInstances, STATGROUP_Flow, FLOW_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active Nodes"), STAT_FlowActiveNodes, STATGROUP_Flow, FLOW_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Component Registry Entries"), STAT_FlowRegisteredComponents, STATGROUP_Flow, FLOW_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Signals"), STAT_FlowSignals, STATGROUP_Flow, FLOW_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Instances Created"), STAT_FlowInstancesCreated, STATGROUP_Flow, FLOW_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Instances Destroyed"), STAT_FlowInstancesDestroyed, STATGROUP_Flow, FLOW_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Registry Queries"), STAT_FlowRegistryQueries, STATGROUP_Flow, FLOW_API);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Save Game"), STAT_FlowSaveGame, STATGROUP_Flow, FLOW_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load Instance"), STAT_FlowLoadInstance, STATGROUP_Flow, FLOW_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(FLOW_API, Flow);
+
+// Gauge keeps its value between frames, i.e. number of live instances
+#define FLOW_INC_GAUGE(Gauge, Amount) \
+	do { INC_DWORD_STAT_BY(STAT_Flow##Gauge, Amount); FlowProfiling::Gauges.Gauge += (Amount); } while (0)
+
+#define FLOW_DEC_GAUGE(Gauge, Amount) \
+	do { DEC_DWORD_STAT_BY(STAT_Flow##Gauge, Amount); FlowProfiling::Gauges.Gauge -= (Amount); } while (0)
+
+// Counter is reset every frame, i.e. number of signals passed in this frame
+#define FLOW_INC_COUNTER(Counter) \
+	do { INC_DWORD_STAT(STAT_Flow##Counter); CSV_CUSTOM_STAT(Flow, Counter, 1, ECsvCustomStatOp::Accumulate); } while (0)
+
+#define FLOW_SCOPE_TIMING(Stat) \
+	SCOPE_CYCLE_COUNTER(STAT_Flow##Stat); \
+	CSV_SCOPED_TIMING_STAT(Flow, Stat)
+
+#define FLOW_TRACE_SCOPE(Name) \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(Name, FlowChannel)
+
+// Event names include the node class and the template asset, they're formatted only while the channel is enabled
+#define FLOW_TRACE_NODE_SCOPE(Name, Node) \
+	TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL(UE_TRACE_CHANNELEXPR_IS_ENABLED(FlowChannel) ? *FlowProfiling::GetNodeEventName(TEXT(Name), Node) : TEXT(Name), FlowChannel)
+
+#define FLOW_TRACE_ASSET_SCOPE(Name, FlowAsset) \
+	TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL(UE_TRACE_CHANNELEXPR_IS_ENABLED(FlowChannel) ? *FlowProfiling::GetAssetEventName(TEXT(Name), FlowAsset) : TEXT(Name), FlowChannel)
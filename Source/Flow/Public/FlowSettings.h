@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Engine/DeveloperSettings.h"
+#include "FlowTypes.h"
 #include "Templates/SubclassOf.h"
 #include "UObject/SoftObjectPath.h"
 #include "FlowSettings.generated.h"
@@ -39,6 +40,58 @@ class FLOW_API UFlowSettings : public UDeveloperSettings
 	UPROPERTY(Config, EditAnywhere, Category = "Flow")
 	bool bLogOnSignalPassthrough;
 
+	// If enabled, signals between nodes are queued and processed in a loop by Flow Asset instance, instead of recursively calling connected nodes
+	// Signals are processed in the same order, although the node triggering outputs completes its ExecuteInput before connected nodes are executed
+	UPROPERTY(Config, EditAnywhere, Category = "Execution")
+	bool bQueueSignals;
+
+	// Maximum number of queued signals processed in a single frame, remaining signals are processed in the next frame
+	// Set it to 0 to process all signals immediately
+	UPROPERTY(Config, EditAnywhere, Category = "Execution", meta = (EditCondition = "bQueueSignals", ClampMin = 0))
+	int32 MaxSignalsPerFrame;
+
+	// Time in milliseconds Flow Subsystem can spend in a single frame on starting Root Flows and processing queued signals
+	// Root Flows requested after exceeding the budget are started in the next frames, in order of their priority
+	// Set it to 0 to start all Root Flows immediately
+	UPROPERTY(Config, EditAnywhere, Category = "Execution", meta = (ClampMin = 0, Units = "ms"))
+	float FrameBudgetMs;
+
+	// Maximum nesting of signals passed synchronously within a single Flow Asset instance, protects against loops ending with stack overflow
+	// Set it to 0 to disable the limit
+	UPROPERTY(Config, EditAnywhere, Category = "Execution", meta = (ClampMin = 0))
+	int32 MaxSignalDepth;
+
+	// Maximum number of signals passed by a single Flow Asset instance in a frame, protects against loops stalling the frame
+	// Set it to 0 to disable the limit
+	UPROPERTY(Config, EditAnywhere, Category = "Execution", meta = (ClampMin = 0))
+	int32 MaxInstanceSignalsPerFrame;
+
+	// Action taken after exceeding any of the above limits, the report lists nodes and pins that formed the loop
+	UPROPERTY(Config, EditAnywhere, Category = "Execution")
+	EFlowSignalLimitPolicy SignalLimitPolicy;
+
+	// If enabled, Flow Asset instances don't duplicate stateless nodes like Reroute or Sequence, template node executes on behalf of all instances
+	// Flow Debugger doesn't display pin activations of such nodes
+	UPROPERTY(Config, EditAnywhere, Category = "Execution")
+	bool bShareStatelessNodes;
+
+	// If enabled, runtime representation of graph loaded outside of the editor skips reroutes and nodes statically set to pass-through
+	// Nodes unreachable from Start or Custom Input nodes aren't instantiated until something triggers them directly
+	// Graph assets aren't modified, and graphs loaded in the editor are never optimized, so Flow Debugger shows every node
+	UPROPERTY(Config, EditAnywhere, Category = "Execution")
+	bool bOptimizeCompiledGraph;
+
+	// If enabled, SubGraph assets are streamed in asynchronously, and their instances are created by Flow Subsystem within the frame budget
+	// Start and custom inputs triggered while SubGraph is being prepared are queued, Finish output is triggered after the SubGraph completes as usual
+	UPROPERTY(Config, EditAnywhere, Category = "Execution")
+	bool bAsyncSubGraphs;
+
+	// Memory that content preloaded by nodes can take, estimated by nodes themselves
+	// After exceeding it, Flow Subsystem flushes the least recently used preloads of nodes that aren't active
+	// Set it to 0 to disable the limit and tracking of preloaded content
+	UPROPERTY(Config, EditAnywhere, Category = "Execution", meta = (ClampMin = 0, Units = "MB"))
+	int32 PreloadBudgetMB;
+
 	// Adjust the Titles for FlowNodes to be more expressive than default
 	// by incorporating data that would otherwise go in the Description
 	UPROPERTY(EditAnywhere, config, Category = "Nodes")
@@ -2,14 +2,22 @@
 
 #pragma once
 
+#include "Containers/Ticker.h"
+#include "Engine/StreamableManager.h"
 #include "GameFramework/Actor.h"
 #include "GameplayTagContainer.h"
 #include "Subsystems/GameInstanceSubsystem.h"
+#include "UObject/ObjectKey.h"
 
 #include "FlowComponent.h"
+#include "Types/FlowInstancedTemplate.h"
+#include "Types/FlowInstancePool.h"
+#include "Types/FlowPreloadBudget.h"
+#include "Types/FlowScheduler.h"
 #include "FlowSubsystem.generated.h"
 
 class UFlowAsset;
+class UFlowNode;
 class UFlowNode_SubGraph;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FSimpleFlowEvent);
@@ -34,17 +42,24 @@ public:
 
 	friend class UFlowAsset;
 	friend class UFlowComponent;
+	friend class UFlowNode;
 	friend class UFlowNode_SubGraph;
 
 private:
 	/* All asset templates with active instances */
 	UPROPERTY()
-	TArray<UFlowAsset*> InstancedTemplates;
+	TMap<UFlowAsset*, FFlowInstancedTemplateStats> InstancedTemplates;
 
 	/* Assets instanced by object from another system, i.e. World Settings or Player Controller */
 	UPROPERTY()
 	TMap<UFlowAsset*, TWeakObjectPtr<UObject>> RootInstances;
 
+	/* Root instances indexed by the owner, in order of creation */
+	TMap<FObjectKey, TArray<UFlowAsset*, TInlineAllocator<1>>> RootInstancesByOwner;
+
+	/* Root instances indexed by the owner and the template asset, there can be only one such instance */
+	TMap<TPair<FObjectKey, FObjectKey>, UFlowAsset*> RootInstancesByOwnerAndTemplate;
+
 	/* Assets instanced by Sub Graph nodes */
 	UPROPERTY()
 	TMap<UFlowNode_SubGraph*, UFlowAsset*> InstancedSubFlows;
@@ -71,7 +86,23 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "FlowSubsystem")
 	virtual void AbortActiveFlows();
 
-	/* Start the root Flow, graph that will eventually instantiate next Flow Graphs through the SubGraph node */
+	/* Nodes may skip unbinding from subsystem delegates while this is true, all bindings of Flow instances are removed after the teardown */
+	bool IsTearingDown() const { return bTearingDown; }
+
+protected:
+	/* Set while AbortActiveFlows finishes all instances at once
+	 * Finishing an instance skips bookkeeping of a single flow, as subsystem empties its containers in bulk afterwards */
+	bool bTearingDown;
+
+	/* Removes bindings of nodes that skipped unbinding during the teardown */
+	void RemoveTornDownBindings();
+
+	/* Reports instances and delegate bindings which survived the teardown */
+	void VerifyTeardown() const;
+
+public:
+	/* Start the root Flow, graph that will eventually instantiate next Flow Graphs through the SubGraph node
+	 * If Flow Settings define the frame budget and it's exceeded, starting the flow is deferred to one of the next frames */
 	UFUNCTION(BlueprintCallable, Category = "FlowSubsystem", meta = (DefaultToSelf = "Owner"))
 	virtual void StartRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const bool bAllowMultipleInstances = true);
 
@@ -91,13 +122,23 @@ public:
 
 protected:
 	UFlowAsset* CreateSubFlow(UFlowNode_SubGraph* SubGraphNode, const FString SavedInstanceName = FString(), const bool bPreloading = false);
+	UFlowAsset* InstantiateSubFlow(UFlowNode_SubGraph* SubGraphNode, const FString& SavedInstanceName, const bool bPreloading);
 	void RemoveSubFlow(UFlowNode_SubGraph* SubGraphNode, const EFlowFinishPolicy FinishPolicy);
 
 	UFlowAsset* CreateFlowInstance(const TWeakObjectPtr<UObject> Owner, TSoftObjectPtr<UFlowAsset> FlowAsset, FString NewInstanceName = FString());
 
+	void AddRootInstance(UObject* Owner, UFlowAsset* Instance);
+	void RemoveRootInstance(const UObject* Owner, UFlowAsset* Instance);
+
+	/* Removes the instance from root flows of any owner, also if the owner no longer exists */
+	void UnregisterRootInstance(UFlowAsset* Instance);
+
 	virtual void AddInstancedTemplate(UFlowAsset* Template);
 	virtual void RemoveInstancedTemplate(UFlowAsset* Template);
 
+	/* Updates instance count of the template, the last removed instance removes the template */
+	void OnInstanceRemoved(UFlowAsset* Template, const int32 InstancesLeft);
+
 public:
 	/* Returns all assets instanced by object from another system like World Settings */
 	UFUNCTION(BlueprintPure, Category = "FlowSubsystem")
@@ -110,15 +151,191 @@ public:
 	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (DeprecatedFunction, DeprecationMessage="Use GetRootInstancesByOwner() instead."))
 	UFlowAsset* GetRootFlow(const UObject* Owner) const;
 
+	/* Non-allocating alternatives to the above, iterating root instances doesn't require building a new container */
+	const TMap<UFlowAsset*, TWeakObjectPtr<UObject>>& GetAllRootInstances() const { return RootInstances; }
+	TConstArrayView<UFlowAsset*> FindRootInstancesByOwner(const UObject* Owner) const;
+	UFlowAsset* FindRootInstance(const UObject* Owner, const UFlowAsset* TemplateAsset) const;
+
+	/* Returns all asset templates with active instances */
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem")
+	const TMap<UFlowAsset*, FFlowInstancedTemplateStats>& GetInstancedTemplates() const { return InstancedTemplates; }
+
+	/* Returns instance counts of the template, or sum of all templates if Template is null, the peak is then the highest peak of a single template */
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem")
+	FFlowInstancedTemplateStats GetInstancedTemplateStats(const UFlowAsset* Template = nullptr) const;
+
 	/* Returns assets instanced by Sub Graph nodes */
 	UFUNCTION(BlueprintPure, Category = "FlowSubsystem")
 	const TMap<UFlowNode_SubGraph*, UFlowAsset*>& GetInstancedSubFlows() const { return InstancedSubFlows; }
 
 	virtual UWorld* GetWorld() const override;
 
+//////////////////////////////////////////////////////////////////////////
+// Execution scheduling
+
+protected:
+	/* Root Flows requested after running out of the frame budget, sorted by priority */
+	TArray<FFlowPendingRootFlow> PendingRootFlows;
+
+	/* Flow Asset instances waiting for the next frame to process the rest of queued signals */
+	TArray<TWeakObjectPtr<UFlowAsset>> DeferredSignalInstances;
+
+	/* Flow Asset instances aborted by the signal limit, removed in the next frame once the signal loop unwound */
+	TArray<TWeakObjectPtr<UFlowAsset>> AbortedInstances;
+
+	FTSTicker::FDelegateHandle SchedulerTickerHandle;
+
+	uint64 SignalBudgetFrame;
+	int32 SignalsInCurrentFrame;
+
+	uint64 TimeBudgetFrame;
+	double TimeSpentInCurrentFrame;
+
+	/* Start time of the outermost budgeted scope, if any is currently open */
+	double BudgetedWorkStartTime;
+	int32 BudgetedWorkDepth;
+
+	FFlowSchedulerStats SchedulerStats;
+
+public:
+	/* Returns false if Flow Settings limit signals processed per frame, and this limit has been already reached */
+	bool HasSignalBudget();
+	bool ConsumeSignalBudget();
+
+	/* Instance ran out of signal budget, its queue will be processed in the next frame */
+	void DeferSignalQueue(UFlowAsset* FlowInstance);
+
+	/* Instance has been aborted by the signal limit, it will be finished by its owner in the next frame */
+	void DeferAbortedInstance(UFlowAsset* FlowInstance);
+
+	/* Returns true if time spent on starting flows and processing signals in this frame exceeded the budget set in Flow Settings */
+	bool IsFrameBudgetExceeded();
+
+	/* Number of Root Flows waiting for the frame budget */
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem")
+	int32 GetNumPendingRootFlows() const { return PendingRootFlows.Num(); }
+
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem")
+	const FFlowSchedulerStats& GetSchedulerStats() const { return SchedulerStats; }
+
+	UFUNCTION(BlueprintCallable, Category = "FlowSubsystem")
+	void ResetSchedulerStats();
+
+protected:
+	/* Priority of Root Flow started by time-sliced scheduler, sum of Flow Asset priority and Flow Component priority */
+	virtual int32 GetRootFlowPriority(const UObject* Owner, const UFlowAsset* FlowAsset) const;
+
+	/* Returns null if the same flow is already waiting for the frame budget */
+	FFlowPendingRootFlow* QueueRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const bool bAllowMultipleInstances);
+	void RemovePendingRootFlows(const UObject* Owner, const UFlowAsset* TemplateAsset = nullptr);
+
+	void StartSchedulerTicker();
+	bool TickScheduler(float DeltaTime);
+	void FinishAbortedInstances();
+
+	void BeginBudgetedWork();
+	void EndBudgetedWork();
+
+//////////////////////////////////////////////////////////////////////////
+// Asynchronous loading
+
+protected:
+	/* Root Flows waiting for their assets to be loaded */
+	TArray<FFlowAsyncRootFlow> AsyncRootFlows;
+	int32 NextAsyncRequestId;
+
+	/* SubGraphs waiting for their assets to be loaded or for the frame budget to be instanced, in order of requests */
+	TArray<FFlowAsyncSubFlow> AsyncSubFlows;
+
+	FStreamableManager StreamableManager;
+
+public:
+	/* Start the root Flow after loading the asset and its hard dependencies asynchronously, without blocking the game thread
+	 * On Started is called with the started instance, after the start deferred by the frame budget if needed (see FFlowAsyncRootFlowEvent)
+	 * Loading is cancelled if the Owner gets destroyed or finishes its Root Flows before it completes */
+	UFUNCTION(BlueprintCallable, Category = "FlowSubsystem", meta = (DefaultToSelf = "Owner", AutoCreateRefTerm = "OnStarted"))
+	virtual void StartRootFlowAsync(UObject* Owner, TSoftObjectPtr<UFlowAsset> FlowAsset, const FFlowAsyncRootFlowEvent& OnStarted, const bool bAllowMultipleInstances = true);
+
+	/* Number of Root Flows waiting for their assets to be loaded */
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem")
+	int32 GetNumLoadingRootFlows() const { return AsyncRootFlows.Num(); }
+
+	/* Number of SubGraphs waiting for their assets to be loaded or instanced */
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem")
+	int32 GetNumLoadingSubFlows() const { return AsyncSubFlows.Num(); }
+
+protected:
+	void OnRootFlowAssetLoaded(const int32 RequestId);
+	void StartLoadedRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const bool bAllowMultipleInstances, const FFlowAsyncRootFlowEvent& OnStarted, const TSharedPtr<FStreamableHandle>& LoadHandle);
+	void CancelAsyncRootFlows(const UObject* Owner, const UFlowAsset* TemplateAsset = nullptr);
+
+	FFlowAsyncSubFlow* FindAsyncSubFlow(const UFlowNode_SubGraph* SubGraphNode);
+	void RequestAsyncSubFlow(UFlowNode_SubGraph* SubGraphNode, const bool bStartRequested);
+
+	/* Returns true if the custom input has been queued, as the started SubGraph is still being prepared */
+	bool QueueSubFlowCustomInput(const UFlowNode_SubGraph* SubGraphNode, const FName& EventName);
+	void OnSubFlowAssetLoaded(TWeakObjectPtr<UFlowNode_SubGraph> SubGraphNode);
+	void CancelAsyncSubFlow(const UFlowNode_SubGraph* SubGraphNode);
+
+	/* Instances loaded SubGraphs until the frame budget is exceeded, returns number of instanced SubGraphs */
+	int32 InstantiateLoadedSubFlows();
+
+//////////////////////////////////////////////////////////////////////////
+// Instance pooling
+
+protected:
+	/* Finished instances kept for reuse, per template asset with the Instance Pool Size set */
+	UPROPERTY()
+	TMap<UFlowAsset*, FFlowInstancePool> InstancePools;
+
+	UFlowAsset* AcquirePooledInstance(UFlowAsset* Template);
+	void ReleaseFlowInstance(UFlowAsset* Instance);
+
+	/* Pooled instance might keep the name of the instance restored from the SaveGame */
+	void EvictPooledInstance(const FString& InstanceName);
+
+public:
+	/* Creates instances in advance, up to the Instance Pool Size of the template asset */
+	UFUNCTION(BlueprintCallable, Category = "FlowSubsystem")
+	void WarmupInstancePool(UFlowAsset* Template, const int32 NumInstances);
+
+	/* Releases pooled instances and resets pool stats, pools are warmed up again when the template is instanced next time */
+	UFUNCTION(BlueprintCallable, Category = "FlowSubsystem")
+	void EmptyInstancePools();
+
+	/* Returns stats of the template's pool, or sum of all pools if Template is null */
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem")
+	FFlowInstancePoolStats GetInstancePoolStats(const UFlowAsset* Template = nullptr) const;
+
+//////////////////////////////////////////////////////////////////////////
+// Preload budget
+
+protected:
+	/* Nodes holding preloaded content, from the least recently used, tracked only if Flow Settings set the Preload Budget */
+	FFlowPreloadList PreloadEntries;
+
+	FFlowPreloadStats PreloadStats;
+
+	void RegisterPreloadedNode(UFlowNode* Node);
+	void UnregisterPreloadedNode(const UFlowNode* Node);
+
+	/* Flushes the least recently used preloads until estimated memory fits the budget, Protected Node is never flushed */
+	void EnforcePreloadBudget(const UFlowNode* ProtectedNode);
+
+public:
+	/* Marks content of the node as recently used, so it's flushed after content of other nodes */
+	void TouchPreloadedNode(const UFlowNode* Node);
+
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem")
+	const FFlowPreloadStats& GetPreloadStats() const { return PreloadStats; }
+
+	UFUNCTION(BlueprintCallable, Category = "FlowSubsystem")
+	void ResetPreloadStats();
+
 //////////////////////////////////////////////////////////////////////////
 // SaveGame support
 
+public:
 	UPROPERTY(BlueprintAssignable, Category = "FlowSubsystem")
 	FSimpleFlowEvent OnSaveGame;
 
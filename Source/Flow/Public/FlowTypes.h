@@ -46,6 +46,15 @@ enum class EFlowSignalMode : uint8
 	PassThrough UMETA(ToolTip = "Internal node logic not executed. All connected outputs are triggered, node finishes its work.")
 };
 
+// Action taken when Flow Asset instance exceeds the signal depth or signals per frame, as set in Flow Settings
+UENUM(BlueprintType)
+enum class EFlowSignalLimitPolicy : uint8
+{
+	Log		UMETA(ToolTip = "Signal is dropped, loop is logged as an error."),
+	Defer	UMETA(ToolTip = "Signal is queued and processed in the next frame, loop is logged as a warning."),
+	Abort	UMETA(ToolTip = "Instance is aborted and ignores signals until it's started again, loop is logged as an error.")
+};
+
 UENUM(BlueprintType)
 enum class EFlowNetMode : uint8
 {
@@ -12,6 +12,8 @@
 
 #include "FlowNode.generated.h"
 
+struct FFlowCompiledGraph;
+
 /**
  * A Flow Node is UObject-based node designed to handle entire gameplay feature within single node.
  */
@@ -26,6 +28,8 @@ class FLOW_API UFlowNode
 	friend class UFlowAsset;
 	friend class UFlowGraphNode;
 	friend class UFlowNodeAddOn;
+	friend struct FFlowCompiledGraph;
+	friend struct FFlowStatelessNodeScope;
 	friend class SFlowInputPinHandle;
 	friend class SFlowOutputPinHandle;
 
@@ -82,6 +86,13 @@ protected:
 	UPROPERTY()
 	EFlowSignalMode SignalMode;
 
+public:
+	EFlowSignalMode GetSignalMode() const { return SignalMode; }
+
+	// Returns true if passing through only triggers connected outputs, so the compiled graph can fold the node
+	// Overriding OnPassThrough_Implementation doesn't create a new function to detect, so classes opt in by returning true
+	virtual bool HasDefaultPassThrough() const;
+
 //////////////////////////////////////////////////////////////////////////
 // All created pins (default, class-specific and added by user)
 
@@ -161,6 +172,7 @@ public:
 	void SetConnections(const TMap<FName, FConnectedPin>& InConnections) { Connections = InConnections; }
 	FConnectedPin GetConnection(const FName OutputName) const { return Connections.FindRef(OutputName); }
 
+	// Returns template nodes for connected nodes not instantiated yet, if Flow Asset instantiates nodes on demand
 	UFUNCTION(BlueprintPure, Category= "FlowNode")
 	TSet<UFlowNode*> GetConnectedNodes() const;
 	
@@ -172,6 +184,12 @@ public:
 	UFUNCTION(BlueprintPure, Category= "FlowNode")
 	bool IsOutputConnected(const FName& PinName) const;
 
+	// Returns compiled graph of the owning Flow Asset, if it's built and includes this node
+	const FFlowCompiledGraph* GetCompiledGraph() const;
+
+	// Compiled indices of connected nodes, doesn't allocate memory. Empty if the compiled graph isn't available
+	TConstArrayView<int32> GetConnectedNodeIndices() const;
+
 	static void RecursiveFindNodesByClass(UFlowNode* Node, const TSubclassOf<UFlowNode> Class, uint8 Depth, TArray<UFlowNode*>& OutNodes);
 
 //////////////////////////////////////////////////////////////////////////
@@ -193,25 +211,61 @@ protected:
 	UPROPERTY(SaveGame)
 	EFlowNodeState ActivationState;
 
+	// Index of this node in the compiled graph of Flow Asset, INDEX_NONE if it's not a part of compiled graph
+	int32 CompiledIndex;
+
+	// Set in the constructor of node class that doesn't keep any per-instance state, i.e. routing nodes
+	// Flow Asset instances might execute such template node directly, instead of duplicating it
+	uint8 bStateless : 1;
+
+	// Set in the constructor of node class that resets its runtime state in Cleanup() or DeinitializeInstance()
+	// Finished Flow Asset instances are pooled only if all their nodes are reusable, subclasses adding runtime state should clear this flag
+	uint8 bReusable : 1;
+
+	// Flow Asset instance on behalf of which this template node is executing now
+	UFlowAsset* StatelessExecutionInstance;
+
 public:
 	EFlowNodeState GetActivationState() const { return ActivationState; }
+	int32 GetCompiledIndex() const { return CompiledIndex; }
+
+	// Nodes with AddOns are never stateless, as AddOns require initializing per node instance
+	virtual bool IsStateless() const { return bStateless && AddOns.Num() == 0; }
+	UFlowAsset* GetStatelessExecutionInstance() const { return StatelessExecutionInstance; }
+
+	// Nodes with AddOns aren't reusable, as AddOns might keep their own runtime state
+	virtual bool IsReusable() const { return IsStateless() || (bReusable && AddOns.Num() == 0); }
 
 #if !UE_BUILD_SHIPPING
 
 private:
-	TMap<FName, TArray<FPinRecord>> InputRecords;
-	TMap<FName, TArray<FPinRecord>> OutputRecords;
+	// Indexed by pin index, capacity is set by the Flow Asset
+	TArray<FPinRecordBuffer> InputRecords;
+	TArray<FPinRecordBuffer> OutputRecords;
+
+	void RecordPinActivation(TArray<FPinRecordBuffer>& Records, const int32 NumPins, const int32 PinIndex, const EFlowPinActivationType ActivationType) const;
 #endif
 
 public:
 	void TriggerPreload();
 	void TriggerFlush();
 
+	// Memory used by the preloaded content, Flow Subsystem flushes the least recently used preloads after exceeding the Preload Budget
+	// Nodes returning 0 are never flushed by the budget
+	virtual int64 EstimatePreloadedMemory() { return 0; }
+
+	// Loaded asset measured by EstimatePreloadedMemory, if the content isn't owned by this node
+	// Nodes preloading the same asset count its memory once, and it's freed only after flushing all of them
+	virtual UObject* GetPreloadedAsset() const { return nullptr; }
+
 protected:
 
 	// Trigger execution of input pin
 	void TriggerInput(const FName& PinName, const EFlowPinActivationType ActivationType = EFlowPinActivationType::Default);
 
+	// Trigger execution of input pin, PinIndex is the index in InputPins array
+	void TriggerInputByIndex(const int32 PinIndex, const EFlowPinActivationType ActivationType = EFlowPinActivationType::Default);
+
 protected:
 	void Deactivate();
 
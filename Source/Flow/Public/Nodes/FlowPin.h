@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "Misc/DateTime.h"
 #include "UObject/ObjectMacros.h"
 #include "FlowPin.generated.h"
 
@@ -263,7 +264,10 @@ enum class EFlowPinActivationType : uint8
 struct FLOW_API FPinRecord
 {
 	double Time;
-	FString HumanReadableTime;
+
+	// Formatted only when the record is displayed
+	FDateTime SystemTime;
+
 	EFlowPinActivationType ActivationType;
 
 	static FString NoActivations;
@@ -274,9 +278,36 @@ struct FLOW_API FPinRecord
 	FPinRecord();
 	FPinRecord(const double InTime, const EFlowPinActivationType InActivationType);
 
+	FString GetHumanReadableTime() const;
+
 private:
 	FORCEINLINE static FString DoubleDigit(const int32 Number);
 };
+
+// Fixed-capacity history of pin activations, the oldest record is overwritten once the buffer is full
+struct FLOW_API FPinRecordBuffer
+{
+private:
+	TArray<FPinRecord> Records;
+
+	// Position of the next write, the oldest record once the buffer is full
+	int32 NextRecord;
+
+public:
+	FPinRecordBuffer()
+		: NextRecord(0)
+	{
+	}
+
+	void Add(const FPinRecord& Record, const int32 Capacity);
+	void Reset();
+
+	int32 Num() const { return Records.Num(); }
+	const FPinRecord& Last() const;
+
+	// Returns records from the oldest one
+	TArray<FPinRecord> GetRecords() const;
+};
 #endif
 
 // It can represent any trait added on the specific node instance, i.e. breakpoint
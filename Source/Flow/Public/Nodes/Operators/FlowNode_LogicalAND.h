@@ -23,6 +23,10 @@ public:
 	virtual bool CanUserAddInput() const override { return true; }
 #endif
 
+public:
+	// subclasses might override OnPassThrough
+	virtual bool HasDefaultPassThrough() const override { return GetClass() == StaticClass(); }
+
 protected:
 	virtual void ExecuteInput(const FName& PinName) override;
 	virtual void Cleanup() override;
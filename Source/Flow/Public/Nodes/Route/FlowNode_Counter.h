@@ -21,6 +21,10 @@ private:
 	UPROPERTY(SaveGame)
 	int32 CurrentSum;
 
+public:
+	// subclasses might override OnPassThrough
+	virtual bool HasDefaultPassThrough() const override { return GetClass() == StaticClass(); }
+
 protected:
 	virtual void ExecuteInput(const FName& PinName) override;
 	virtual void Cleanup() override;
@@ -34,6 +34,9 @@ public:
 	virtual bool CanUserAddOutput() const override { return true; }
 #endif
 
+	// Saving pin execution state requires per-instance state
+	virtual bool IsStateless() const override { return !bSavePinExecutionState && Super::IsStateless(); }
+
 protected:
 	virtual void ExecuteInput(const FName& PinName) override;
 	virtual void OnLoad_Implementation() override;
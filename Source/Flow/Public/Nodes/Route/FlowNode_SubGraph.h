@@ -40,6 +40,10 @@ protected:
 	virtual void PreloadContent() override;
 	virtual void FlushContent() override;
 
+public:
+	virtual int64 EstimatePreloadedMemory() override;
+
+protected:
 	virtual void ExecuteInput(const FName& PinName) override;
 	virtual void Cleanup() override;
 
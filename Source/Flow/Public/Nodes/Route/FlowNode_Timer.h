@@ -36,6 +36,10 @@ private:
 	UPROPERTY(SaveGame)
 	float RemainingStepTime;
 
+public:
+	// subclasses might override OnPassThrough
+	virtual bool HasDefaultPassThrough() const override { return GetClass() == StaticClass(); }
+
 protected:
 	virtual void ExecuteInput(const FName& PinName) override;
 
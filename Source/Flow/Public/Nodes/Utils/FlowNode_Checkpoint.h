@@ -14,6 +14,9 @@ class FLOW_API UFlowNode_Checkpoint final : public UFlowNode
 {
 	GENERATED_UCLASS_BODY()
 
+public:
+	virtual bool HasDefaultPassThrough() const override { return true; }
+
 protected:
 	virtual void ExecuteInput(const FName& PinName) override;
 	virtual void OnLoad_Implementation() override;
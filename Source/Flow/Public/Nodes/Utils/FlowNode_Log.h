@@ -42,6 +42,10 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Flow", meta = (EditCondition = "bPrintToScreen"))
 	FColor TextColor;
 
+public:
+	// subclasses might override OnPassThrough
+	virtual bool HasDefaultPassThrough() const override { return GetClass() == StaticClass(); }
+
 protected:
 	virtual void ExecuteInput(const FName& PinName) override;
 
@@ -95,6 +95,8 @@ public:
 
 	virtual void PreloadContent() override;
 	virtual void FlushContent() override;
+	virtual int64 EstimatePreloadedMemory() override;
+	virtual UObject* GetPreloadedAsset() const override;
 
 	virtual void InitializeInstance() override;
 	void CreatePlayer();
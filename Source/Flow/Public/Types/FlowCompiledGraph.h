@@ -0,0 +1,163 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Containers/ArrayView.h"
+#include "Containers/BitArray.h"
+#include "Misc/Guid.h"
+#include "UObject/NameTypes.h"
+
+class UFlowNode;
+
+// Output pin resolved to the connected node and its input pin, both addressed by index
+struct FLOW_API FFlowCompiledConnection
+{
+	int32 NodeIndex;
+	int32 InputPinIndex;
+
+	// Used if the connected node doesn't have such input pin, so the regular error reporting applies
+	FName InputPinName;
+
+	FFlowCompiledConnection()
+		: NodeIndex(INDEX_NONE)
+		, InputPinIndex(INDEX_NONE)
+		, InputPinName(NAME_None)
+	{
+	}
+
+	FORCEINLINE bool IsConnected() const { return NodeIndex != INDEX_NONE; }
+};
+
+// Node entry, pins are stored as ranges in the flat pin arrays of the compiled graph
+struct FLOW_API FFlowCompiledNode
+{
+	FGuid NodeGuid;
+
+	int32 FirstInputPin;
+	int32 NumInputPins;
+
+	int32 FirstOutputPin;
+	int32 NumOutputPins;
+
+	// Ranges in the adjacency arrays of the compiled graph, as authored in the editor
+	int32 FirstSuccessor;
+	int32 NumSuccessors;
+
+	int32 FirstPredecessor;
+	int32 NumPredecessors;
+
+	// False if optimization found that no signal can reach this node
+	bool bReachable;
+
+	// Node has been removed from the signal path by optimization, connections lead directly to the node it passes signal to
+	bool bFolded;
+
+	FFlowCompiledNode()
+		: FirstInputPin(0)
+		, NumInputPins(0)
+		, FirstOutputPin(0)
+		, NumOutputPins(0)
+		, FirstSuccessor(0)
+		, NumSuccessors(0)
+		, FirstPredecessor(0)
+		, NumPredecessors(0)
+		, bReachable(true)
+		, bFolded(false)
+	{
+	}
+};
+
+/**
+ * Runtime representation of the Flow Asset graph, built once per template asset and shared by all its instances
+ * Nodes and pins are addressed by indices, so passing a signal between nodes doesn't require any map lookups
+ */
+struct FLOW_API FFlowCompiledGraph
+{
+	TArray<FFlowCompiledNode> Nodes;
+
+	// Pin names of all nodes, every node owns a continuous range
+	TArray<FName> InputPinNames;
+	TArray<FName> OutputPinNames;
+
+	// Parallel to OutputPinNames
+	TArray<FFlowCompiledConnection> OutputConnections;
+
+	// Parallel to InputPinNames, set if any output pin is connected to the input pin
+	TBitArray<> ConnectedInputPins;
+
+	// Unique indices of nodes connected to outputs and inputs of every node
+	// Built from connections before optimization, so graph queries see the graph as authored
+	TArray<int32> Successors;
+	TArray<int32> Predecessors;
+
+	TMap<FGuid, int32> NodeIndices;
+
+	// Node indices grouped by the exact node class
+	TMap<const UClass*, TArray<int32>> NodesByClass;
+
+	// Custom Input and Custom Output nodes by event name, nodes without the event name aren't included
+	TMap<FName, TArray<int32>> CustomInputNodes;
+	TMap<FName, TArray<int32>> CustomOutputNodes;
+
+	// Event names in order of node indices, as gathered from nodes
+	TArray<FName> CustomInputNames;
+	TArray<FName> CustomOutputNames;
+
+	// Start node used if flow isn't started from a specific entry node
+	int32 DefaultEntryNode;
+
+	// Depth-first order of nodes visited from every entry node, i.e. node without input pins like Start or Custom Input
+	TMap<int32, TArray<int32>> ExecutionOrders;
+
+	int32 NumFoldedNodes;
+	int32 NumUnreachableNodes;
+
+public:
+	FFlowCompiledGraph()
+		: DefaultEntryNode(INDEX_NONE)
+		, NumFoldedNodes(0)
+		, NumUnreachableNodes(0)
+	{
+	}
+
+
+	// Optimization splices reroutes and statically known pass-through nodes out of connections, and marks nodes unreachable from entry nodes
+	void Build(const TMap<FGuid, UFlowNode*>& InNodes, const bool bOptimize = false);
+	void Reset();
+
+	// Returns false if nodes or their pins differ from the state used to build this graph
+	bool IsUpToDate(const TMap<FGuid, UFlowNode*>& InNodes) const;
+
+	int32 Num() const { return Nodes.Num(); }
+	bool IsValidNodeIndex(const int32 NodeIndex) const { return Nodes.IsValidIndex(NodeIndex); }
+
+	int32 FindNodeIndex(const FGuid& NodeGuid) const;
+	bool IsReachable(const int32 NodeIndex) const { return Nodes.IsValidIndex(NodeIndex) && Nodes[NodeIndex].bReachable; }
+	bool IsFolded(const int32 NodeIndex) const { return Nodes.IsValidIndex(NodeIndex) && Nodes[NodeIndex].bFolded; }
+
+	// Returns connection assigned to the output pin, OutputPinIndex is local to the node
+	const FFlowCompiledConnection* FindConnection(const int32 NodeIndex, const int32 OutputPinIndex) const;
+
+	// Nodes connected to outputs of the given node, in order of its connections
+	TConstArrayView<int32> GetSuccessors(const int32 NodeIndex) const;
+
+	// Nodes having any output connected to inputs of the given node
+	TConstArrayView<int32> GetPredecessors(const int32 NodeIndex) const;
+
+	TConstArrayView<int32> GetNodesByClass(const UClass* NodeClass) const;
+
+	TConstArrayView<int32> FindCustomInputNodes(const FName& EventName) const;
+	TConstArrayView<int32> FindCustomOutputNodes(const FName& EventName) const;
+
+	// Returns nullptr if given node isn't an entry node
+	const TArray<int32>* FindExecutionOrder(const int32 EntryNodeIndex) const { return ExecutionOrders.Find(EntryNodeIndex); }
+
+	int32 FindInputPinIndex(const int32 NodeIndex, const FName& PinName) const;
+	bool IsInputConnected(const int32 NodeIndex, const FName& PinName) const;
+
+private:
+	void BuildAdjacency(const TArray<const UFlowNode*>& NodeObjects);
+	void BuildLookups(const TArray<const UFlowNode*>& NodeObjects);
+	void Optimize(const TArray<const UFlowNode*>& NodeObjects);
+	static bool CanFoldNode(const UFlowNode* Node);
+};
@@ -0,0 +1,68 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "UObject/ObjectMacros.h"
+#include "FlowInstancePool.generated.h"
+
+class UFlowAsset;
+
+// Usage statistics of Flow Asset instance pool, collected since the subsystem initialization
+USTRUCT(BlueprintType)
+struct FLOW_API FFlowInstancePoolStats
+{
+	GENERATED_USTRUCT_BODY()
+
+	// Instances taken from the pool
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 Hits;
+
+	// Instances created, because the pool was empty
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 Misses;
+
+	// Finished instances returned to the pool
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 Releases;
+
+	// Finished instances not returned to the pool, because it was full or the instance has been outdated
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 Discards;
+
+	// Instances created in advance by warming up the pool
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 WarmedUp;
+
+	FFlowInstancePoolStats()
+		: Hits(0)
+		, Misses(0)
+		, Releases(0)
+		, Discards(0)
+		, WarmedUp(0)
+	{
+	}
+
+	float GetHitRate() const { return Hits + Misses > 0 ? static_cast<float>(Hits) / (Hits + Misses) : 0.0f; }
+
+	FFlowInstancePoolStats& operator+=(const FFlowInstancePoolStats& Other)
+	{
+		Hits += Other.Hits;
+		Misses += Other.Misses;
+		Releases += Other.Releases;
+		Discards += Other.Discards;
+		WarmedUp += Other.WarmedUp;
+		return *this;
+	}
+};
+
+// Finished instances of the single Flow Asset, waiting for reuse
+USTRUCT()
+struct FLOW_API FFlowInstancePool
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	TArray<UFlowAsset*> Instances;
+
+	FFlowInstancePoolStats Stats;
+};
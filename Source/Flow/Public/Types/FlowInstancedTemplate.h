@@ -0,0 +1,48 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "UObject/ObjectMacros.h"
+#include "FlowInstancedTemplate.generated.h"
+
+// Instance counts of the template asset registered in the Flow Subsystem, collected since its first instance has been created
+USTRUCT(BlueprintType)
+struct FLOW_API FFlowInstancedTemplateStats
+{
+	GENERATED_USTRUCT_BODY()
+
+	// Instances currently alive
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 ActiveInstances;
+
+	// The highest number of instances alive at once
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 PeakInstances;
+
+	// Instances created or taken from the pool
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 CreatedInstances;
+
+	FFlowInstancedTemplateStats()
+		: ActiveInstances(0)
+		, PeakInstances(0)
+		, CreatedInstances(0)
+	{
+	}
+
+	void OnInstanceAdded(const int32 NumInstances)
+	{
+		ActiveInstances = NumInstances;
+		PeakInstances = FMath::Max(PeakInstances, NumInstances);
+		CreatedInstances++;
+	}
+
+	FFlowInstancedTemplateStats& operator+=(const FFlowInstancedTemplateStats& Other)
+	{
+		ActiveInstances += Other.ActiveInstances;
+		// peaks of different templates could happen at different times, so their sum would overstate the peak
+		PeakInstances = FMath::Max(PeakInstances, Other.PeakInstances);
+		CreatedInstances += Other.CreatedInstances;
+		return *this;
+	}
+};
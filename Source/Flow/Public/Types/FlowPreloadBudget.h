@@ -0,0 +1,129 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Containers/List.h"
+#include "UObject/ObjectKey.h"
+#include "FlowPreloadBudget.generated.h"
+
+class UFlowNode;
+
+// Node which content has been preloaded, tracked by Flow Subsystem if Flow Settings set the Preload Budget
+struct FLOW_API FFlowPreloadEntry
+{
+	// Key stays valid after the node is destroyed, so its entry can be still found
+	TObjectKey<UFlowNode> Node;
+
+	// Asset measured by the estimate, memory of the asset preloaded by several nodes is counted once
+	FObjectKey Asset;
+
+	// Estimated by the node, content loaded asynchronously is counted after it arrives
+	int64 EstimatedSize;
+
+	FFlowPreloadEntry()
+		: EstimatedSize(0)
+	{
+	}
+
+	FFlowPreloadEntry(const UFlowNode* InNode, const UObject* InAsset, const int64 InEstimatedSize)
+		: Node(InNode)
+		, Asset(InAsset)
+		, EstimatedSize(InEstimatedSize)
+	{
+	}
+};
+
+/**
+ * Preloaded nodes ordered from the least recently used
+ * Entries are indexed by node, so registering, touching and removing node doesn't search the list
+ * Memory of the asset preloaded by several nodes is counted once, and it's freed after flushing all these nodes
+ */
+struct FLOW_API FFlowPreloadList
+{
+	UE_NONCOPYABLE(FFlowPreloadList);
+
+	FFlowPreloadList()
+		: EstimatedBytes(0)
+	{
+	}
+
+	// Adds node as the most recently used, replacing its previous entry
+	void Add(UFlowNode* Node);
+	void Remove(const UFlowNode* Node);
+
+	// Moves node to the end of the list, so it's flushed after other nodes
+	void Touch(const UFlowNode* Node);
+
+	// Measures nodes which content hasn't arrived when they were added
+	void MeasurePendingEntries();
+
+	// Removes the least recently used nodes until estimated memory fits the budget
+	// Protected Node, active nodes and nodes sharing an asset with them are kept, as flushing them wouldn't free memory
+	void RemoveLeastRecentlyUsed(const int64 BudgetBytes, const UFlowNode* ProtectedNode, TArray<UFlowNode*>& OutRemovedNodes);
+
+	void Empty();
+
+	int32 Num() const { return Entries.Num(); }
+	int64 GetEstimatedBytes() const { return EstimatedBytes; }
+
+private:
+	typedef TDoubleLinkedList<FFlowPreloadEntry>::TDoubleLinkedListNode FEntryNode;
+
+	struct FPreloadedAsset
+	{
+		int32 Users;
+		int64 EstimatedSize;
+
+		FPreloadedAsset()
+			: Users(0)
+			, EstimatedSize(0)
+		{
+		}
+	};
+
+	void RemoveEntry(FEntryNode* EntryNode);
+
+	void AddAssetUser(const FFlowPreloadEntry& Entry);
+	void RemoveAssetUser(const FFlowPreloadEntry& Entry);
+
+	TDoubleLinkedList<FFlowPreloadEntry> Entries;
+	TMap<TObjectKey<UFlowNode>, FEntryNode*> EntriesByNode;
+
+	TMap<FObjectKey, FPreloadedAsset> Assets;
+
+	// Nodes estimated to use no memory yet
+	TSet<TObjectKey<UFlowNode>> PendingNodes;
+
+	int64 EstimatedBytes;
+};
+
+// Memory used by preloaded content of all Flow Asset instances, collected since the subsystem initialization or the last reset
+USTRUCT(BlueprintType)
+struct FLOW_API FFlowPreloadStats
+{
+	GENERATED_USTRUCT_BODY()
+
+	// Nodes currently holding preloaded content
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 PreloadedNodes;
+
+	// Sum of memory estimated by preloaded nodes, in bytes, assets shared by nodes are counted once
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int64 EstimatedBytes;
+
+	// The highest memory estimated by preloaded nodes at once, in bytes
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int64 PeakEstimatedBytes;
+
+	// Number of preloads flushed to stay within the budget
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 EvictedNodes;
+
+	FFlowPreloadStats()
+		: PreloadedNodes(0)
+		, EstimatedBytes(0)
+		, PeakEstimatedBytes(0)
+		, EvictedNodes(0)
+	{
+	}
+};
@@ -0,0 +1,63 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Containers/ArrayView.h"
+#include "Containers/BitArray.h"
+#include "Types/FlowCompiledGraph.h"
+
+/**
+ * Finds nodes likely to be triggered soon, by walking the compiled graph from active nodes up to the Preload Distance of Flow Asset
+ * Flow Asset preloads nodes entering this window and flushes nodes that left it
+ * Active nodes are part of the window, so content of running nodes isn't flushed
+ */
+struct FLOW_API FFlowPreloadPredictor
+{
+	int32 Distance;
+
+	// Maximum number of nodes in the window besides active nodes, the nearest nodes are taken first
+	// 0 means no limit
+	int32 MaxNodes;
+
+	// Nodes preloaded by Flow Asset because they entered the window, addressed by the compiled node index
+	TBitArray<> PreloadedBits;
+
+	// Set while Flow Asset preloads and flushes nodes, so nodes activated by that don't update the window recursively
+	bool bUpdating;
+
+	FFlowPreloadPredictor()
+		: Distance(0)
+		, MaxNodes(0)
+		, bUpdating(false)
+	{
+	}
+
+	void Initialize(const int32 InDistance, const int32 InMaxNodes, const int32 NumNodes);
+	void Reset();
+
+	bool IsEnabled() const { return Distance > 0; }
+
+	// Rebuilds the window, changes are available through GetEnteredNodes() and GetLeftNodes()
+	void Update(const FFlowCompiledGraph& Graph, const TBitArray<>& ActiveNodes);
+
+	TConstArrayView<int32> GetEnteredNodes() const { return EnteredNodes; }
+	TConstArrayView<int32> GetLeftNodes() const { return LeftNodes; }
+
+private:
+	TBitArray<> WindowBits;
+	TArray<int32> WindowNodes;
+
+	TBitArray<> NewWindowBits;
+	TArray<int32> NewWindowNodes;
+
+	TArray<int32> EnteredNodes;
+	TArray<int32> LeftNodes;
+
+	// Breadth-first search, nodes at the current and the next distance from active nodes
+	TBitArray<> VisitedBits;
+	TArray<int32> Frontier;
+	TArray<int32> NextFrontier;
+
+	// Frontier node being expanded, followed by folded nodes found behind it
+	TArray<int32> PendingNodes;
+};
@@ -0,0 +1,181 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "UObject/SoftObjectPtr.h"
+#include "UObject/WeakObjectPtr.h"
+#include "FlowScheduler.generated.h"
+
+class UFlowAsset;
+class UFlowNode_SubGraph;
+struct FStreamableHandle;
+
+// Called once the Root Flow instance has started, also if it has been deferred by the frame budget
+// Flow Instance is null if the flow couldn't be started, i.e. loading failed or the Owner already runs this flow
+// Not called if the Owner has been destroyed or it finished its Root Flows before the flow started
+DECLARE_DYNAMIC_DELEGATE_TwoParams(FFlowAsyncRootFlowEvent, UObject*, Owner, UFlowAsset*, FlowInstance);
+
+// Root Flow waiting for the frame budget, started by the Flow Subsystem in one of the next frames
+struct FLOW_API FFlowPendingRootFlow
+{
+	TWeakObjectPtr<UObject> Owner;
+	TWeakObjectPtr<UFlowAsset> FlowAsset;
+	bool bAllowMultipleInstances;
+
+	// Higher priority flows are started first
+	int32 Priority;
+
+	uint64 QueuedFrame;
+
+	// Keeps asynchronously loaded asset in memory until the flow starts
+	TSharedPtr<FStreamableHandle> LoadHandle;
+
+	// Set if the flow has been requested by StartRootFlowAsync
+	FFlowAsyncRootFlowEvent OnStarted;
+
+	FFlowPendingRootFlow()
+		: bAllowMultipleInstances(true)
+		, Priority(0)
+		, QueuedFrame(0)
+	{
+	}
+
+	FFlowPendingRootFlow(UObject* InOwner, UFlowAsset* InFlowAsset, const bool bInAllowMultipleInstances, const int32 InPriority, const uint64 InQueuedFrame)
+		: Owner(InOwner)
+		, FlowAsset(InFlowAsset)
+		, bAllowMultipleInstances(bInAllowMultipleInstances)
+		, Priority(InPriority)
+		, QueuedFrame(InQueuedFrame)
+	{
+	}
+};
+
+// Root Flow waiting for its asset and the asset's hard dependencies to be loaded asynchronously
+struct FLOW_API FFlowAsyncRootFlow
+{
+	int32 RequestId;
+
+	TWeakObjectPtr<UObject> Owner;
+	TSoftObjectPtr<UFlowAsset> FlowAsset;
+	bool bAllowMultipleInstances;
+
+	FFlowAsyncRootFlowEvent OnStarted;
+	TSharedPtr<FStreamableHandle> LoadHandle;
+
+	double RequestTime;
+
+	FFlowAsyncRootFlow()
+		: RequestId(INDEX_NONE)
+		, bAllowMultipleInstances(true)
+		, RequestTime(0.0)
+	{
+	}
+
+	FFlowAsyncRootFlow(const int32 InRequestId, UObject* InOwner, const TSoftObjectPtr<UFlowAsset>& InFlowAsset, const bool bInAllowMultipleInstances, const FFlowAsyncRootFlowEvent& InOnStarted)
+		: RequestId(InRequestId)
+		, Owner(InOwner)
+		, FlowAsset(InFlowAsset)
+		, bAllowMultipleInstances(bInAllowMultipleInstances)
+		, OnStarted(InOnStarted)
+		, RequestTime(FPlatformTime::Seconds())
+	{
+	}
+};
+
+// SubGraph which asset is being loaded asynchronously, or waits for the frame budget to be instanced
+struct FLOW_API FFlowAsyncSubFlow
+{
+	TWeakObjectPtr<UFlowNode_SubGraph> SubGraphNode;
+	TSharedPtr<FStreamableHandle> LoadHandle;
+
+	bool bLoaded;
+
+	// Start input has been triggered while the SubGraph was being prepared
+	bool bStartRequested;
+
+	// Custom inputs triggered after Start, replayed once the SubGraph has been started
+	TArray<FName> PendingCustomInputs;
+
+	double RequestTime;
+
+	FFlowAsyncSubFlow()
+		: bLoaded(false)
+		, bStartRequested(false)
+		, RequestTime(0.0)
+	{
+	}
+
+	FFlowAsyncSubFlow(UFlowNode_SubGraph* InSubGraphNode, const bool bInStartRequested)
+		: SubGraphNode(InSubGraphNode)
+		, bLoaded(false)
+		, bStartRequested(bInStartRequested)
+		, RequestTime(FPlatformTime::Seconds())
+	{
+	}
+};
+
+// Statistics of the work deferred by Flow Subsystem, collected since the subsystem initialization or the last reset
+USTRUCT(BlueprintType)
+struct FLOW_API FFlowSchedulerStats
+{
+	GENERATED_USTRUCT_BODY()
+
+	// Number of Root Flows that couldn't be started in the frame they were requested
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 DeferredRootFlows;
+
+	// The highest number of Root Flows waiting at once
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 PeakPendingRootFlows;
+
+	// The longest time a Root Flow waited for being started, in frames
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 MaxDeferredFrames;
+
+	// Number of Root Flows started after asynchronously loading their assets
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 AsyncLoadedRootFlows;
+
+	// Number of SubGraphs instanced after asynchronously loading their assets
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 AsyncLoadedSubFlows;
+
+	// Number of SubGraphs which Start input had to wait for their assets or the frame budget
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 DeferredSubFlowStarts;
+
+	// The longest time an asset of Root Flow or SubGraph was being loaded asynchronously, in milliseconds
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	float MaxAsyncLoadTimeMs;
+
+	// Number of times a Flow Asset instance had to continue processing its signal queue in the next frame
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 DeferredSignalQueues;
+
+	// Number of frames in which Flow Subsystem spent more time than the frame budget allows
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 FramesOverBudget;
+
+	// Time spent by Flow Subsystem on the budgeted work in the last processed frame, in milliseconds
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	float LastFrameTimeMs;
+
+	// The highest time spent by Flow Subsystem on the budgeted work in a single frame, in milliseconds
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	float PeakFrameTimeMs;
+
+	FFlowSchedulerStats()
+		: DeferredRootFlows(0)
+		, PeakPendingRootFlows(0)
+		, MaxDeferredFrames(0)
+		, AsyncLoadedRootFlows(0)
+		, AsyncLoadedSubFlows(0)
+		, DeferredSubFlowStarts(0)
+		, MaxAsyncLoadTimeMs(0.0f)
+		, DeferredSignalQueues(0)
+		, FramesOverBudget(0)
+		, LastFrameTimeMs(0.0f)
+		, PeakFrameTimeMs(0.0f)
+	{
+	}
+};
@@ -0,0 +1,63 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "FlowTypes.h"
+#include "Types/FlowCompiledGraph.h"
+
+/**
+ * Guards Flow Asset instance against graphs looping synchronously, i.e. Counter feeding back into itself
+ * Counts nesting of signals and signals passed in the current frame, limits are taken from Flow Settings
+ * Recent signals are remembered, so the loop can be reported after exceeding a limit
+ */
+struct FLOW_API FFlowSignalLimiter
+{
+	static constexpr int32 NumRecentSignals = 32;
+
+	int32 MaxDepth;
+	int32 MaxSignalsPerFrame;
+	EFlowSignalLimitPolicy Policy;
+
+	// Nesting of signals currently executed
+	int32 Depth;
+
+	FFlowSignalLimiter()
+		: MaxDepth(0)
+		, MaxSignalsPerFrame(0)
+		, Policy(EFlowSignalLimitPolicy::Log)
+		, Depth(0)
+		, SignalFrame(0)
+		, SignalsInFrame(0)
+		, LimitExceededFrame(MAX_uint64)
+		, NextRecentSignal(0)
+	{
+	}
+
+	void Initialize(const int32 InMaxDepth, const int32 InMaxSignalsPerFrame, const EFlowSignalLimitPolicy InPolicy);
+	void Reset();
+
+	bool IsEnabled() const { return MaxDepth > 0 || MaxSignalsPerFrame > 0; }
+
+	// Counts the signal, returns false if passing it would exceed any of limits
+	bool TryAddSignal(const FFlowCompiledConnection& Signal, bool& bOutDepthExceeded);
+
+	// Returns false if a limit has been already exceeded in the current frame
+	bool MarkLimitExceeded();
+
+	// Returns true if any limit has been exceeded in the current frame
+	bool HasExceededLimitInFrame() const { return LimitExceededFrame == GFrameCounter; }
+
+	// Signals passed since the previous occurrence of the given signal, oldest first
+	// Returns all remembered signals, if the given signal hasn't been passed recently
+	void FindLoop(const FFlowCompiledConnection& Signal, TArray<FFlowCompiledConnection>& OutLoop) const;
+
+private:
+	uint64 SignalFrame;
+	int32 SignalsInFrame;
+	uint64 LimitExceededFrame;
+
+	TArray<FFlowCompiledConnection> RecentSignals;
+
+	// Position of the next write in the ring buffer, the oldest signal once the buffer is full
+	int32 NextRecentSignal;
+};
@@ -0,0 +1,44 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "FlowTypes.h"
+#include "Nodes/FlowPin.h"
+
+class UFlowAsset;
+class UFlowNode;
+
+// Runtime state of the stateless node, kept by Flow Asset instance instead of duplicating the template node
+struct FLOW_API FFlowStatelessNodeState
+{
+	EFlowNodeState ActivationState;
+
+#if !UE_BUILD_SHIPPING
+	TArray<FPinRecordBuffer> InputRecords;
+	TArray<FPinRecordBuffer> OutputRecords;
+#endif
+
+	FFlowStatelessNodeState()
+		: ActivationState(EFlowNodeState::NeverActivated)
+	{
+	}
+};
+
+/**
+ * Binds the template node to Flow Asset instance for the duration of the scope
+ * Node executes with the state kept by this instance, and GetFlowAsset() called on the node returns this instance
+ * Does nothing if the node has been instantiated by Flow Asset instance
+ */
+struct FLOW_API FFlowStatelessNodeScope
+{
+	FFlowStatelessNodeScope(UFlowAsset* InFlowInstance, UFlowNode* InNode);
+	~FFlowStatelessNodeScope();
+
+private:
+	void SwapState() const;
+
+	UFlowAsset* FlowInstance;
+	UFlowNode* Node;
+	UFlowAsset* PreviousInstance;
+	bool bBound;
+};
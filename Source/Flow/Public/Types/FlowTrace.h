@@ -0,0 +1,204 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Nodes/FlowPin.h"
+#include "UObject/ObjectKey.h"
+
+class FArchive;
+class UFlowAsset;
+class UFlowNode;
+
+enum class EFlowTraceEventType : uint8
+{
+	Input,
+	Output
+};
+
+// Signal passed through the node pin, stored in the compact binary form
+struct FLOW_API FFlowTraceEvent
+{
+	double Time;
+	uint64 Frame;
+
+	// Ids of Flow Asset instance and its template assigned by the recorder, resolved to names by the trace file tables
+	uint32 InstanceId;
+	uint32 TemplateId;
+
+	// Node and pin indices, as assigned by the compiled graph of the template
+	int32 NodeIndex;
+	int16 PinIndex;
+
+	EFlowTraceEventType Type;
+	EFlowPinActivationType ActivationType;
+
+	FFlowTraceEvent()
+		: Time(0.0)
+		, Frame(0)
+		, InstanceId(0)
+		, TemplateId(0)
+		, NodeIndex(INDEX_NONE)
+		, PinIndex(INDEX_NONE)
+		, Type(EFlowTraceEventType::Input)
+		, ActivationType(EFlowPinActivationType::Default)
+	{
+	}
+
+	friend FArchive& operator<<(FArchive& Ar, FFlowTraceEvent& Event);
+};
+
+struct FLOW_API FFlowTraceTemplateInfo
+{
+	FString AssetPath;
+
+	// Indexed by the compiled node index
+	TArray<FString> NodeNames;
+};
+
+struct FLOW_API FFlowTraceInstanceInfo
+{
+	uint32 TemplateId;
+	FString InstanceName;
+
+	FFlowTraceInstanceInfo()
+		: TemplateId(0)
+	{
+	}
+};
+
+/**
+ * Records every signal passed between nodes, available in all build configurations including cooked servers
+ * Events are kept in a ring buffer dumped to file on demand, or streamed to file whenever the buffer is full
+ * Controlled by Flow.Trace console commands, or -FlowTrace command line parameter which starts streaming on launch
+ */
+class FLOW_API FFlowTraceRecorder
+{
+public:
+	FFlowTraceRecorder()
+		: Capacity(0)
+		, NextEvent(0)
+		, NextId(1)
+	{
+	}
+
+	static constexpr int32 DefaultCapacity = 65536;
+
+	static FFlowTraceRecorder& Get();
+	static bool IsRecording() { return bRecording; }
+
+	// Starts streaming, if the file name is provided. Otherwise, the oldest events are overwritten once the buffer is full
+	void Start(const int32 InCapacity, const FString& StreamFilename = FString());
+	void Stop();
+
+	bool DumpToFile(const FString& Filename) const;
+	static FString GetDefaultFilename();
+
+	void RecordSignal(const UFlowNode* Node, const EFlowTraceEventType Type, const int32 PinIndex, const EFlowPinActivationType ActivationType);
+
+private:
+	uint32 RegisterInstance(const UFlowAsset* FlowInstance);
+	void FlushStream();
+
+	void WriteTemplate(FArchive& Ar, const uint32 TemplateId, FFlowTraceTemplateInfo& Info) const;
+	void WriteInstance(FArchive& Ar, const uint32 InstanceId, FFlowTraceInstanceInfo& Info) const;
+	void WriteEvents(FArchive& Ar, TArray<FFlowTraceEvent>& InEvents) const;
+
+	static bool bRecording;
+
+	TArray<FFlowTraceEvent> Events;
+	int32 Capacity;
+
+	// Position of the next write in the ring buffer, the oldest event once the buffer is full
+	int32 NextEvent;
+
+	TMap<uint32, FFlowTraceTemplateInfo> Templates;
+	TMap<uint32, FFlowTraceInstanceInfo> Instances;
+
+	// Object unique ids are recycled after garbage collection, so the recorder assigns its own ids
+	TMap<TObjectKey<UFlowAsset>, uint32> TemplateIds;
+	TMap<TObjectKey<UFlowAsset>, uint32> InstanceIds;
+	uint32 NextId;
+
+	TUniquePtr<FArchive> StreamArchive;
+};
+
+struct FLOW_API FFlowTraceNodeStats
+{
+	uint32 TemplateId;
+	int32 NodeIndex;
+
+	int32 NumInputs;
+	int32 NumOutputs;
+
+	// Time between activating node input and triggering its output by the same instance, in seconds
+	double TotalLatency;
+	double MaxLatency;
+	int32 NumLatencySamples;
+
+	FFlowTraceNodeStats()
+		: TemplateId(0)
+		, NodeIndex(INDEX_NONE)
+		, NumInputs(0)
+		, NumOutputs(0)
+		, TotalLatency(0.0)
+		, MaxLatency(0.0)
+		, NumLatencySamples(0)
+	{
+	}
+
+	double GetAverageLatency() const { return NumLatencySamples > 0 ? TotalLatency / NumLatencySamples : 0.0; }
+};
+
+// Number of times the signal went from the node output directly to another node input
+struct FLOW_API FFlowTracePathStats
+{
+	uint32 TemplateId;
+	int32 FromNodeIndex;
+	int32 ToNodeIndex;
+	int32 Count;
+
+	FFlowTracePathStats()
+		: TemplateId(0)
+		, FromNodeIndex(INDEX_NONE)
+		, ToNodeIndex(INDEX_NONE)
+		, Count(0)
+	{
+	}
+};
+
+struct FLOW_API FFlowTraceReport
+{
+	// Sorted by the number of activated inputs
+	TArray<FFlowTraceNodeStats> Nodes;
+
+	// Sorted by count
+	TArray<FFlowTracePathStats> HotPaths;
+
+	double Duration;
+	uint64 NumFrames;
+
+	FFlowTraceReport()
+		: Duration(0.0)
+		, NumFrames(0)
+	{
+	}
+};
+
+// Reads the file written by Flow Trace Recorder
+class FLOW_API FFlowTraceReader
+{
+public:
+	bool LoadFromFile(const FString& Filename);
+
+	const TArray<FFlowTraceEvent>& GetEvents() const { return Events; }
+	const TMap<uint32, FFlowTraceTemplateInfo>& GetTemplates() const { return Templates; }
+	const TMap<uint32, FFlowTraceInstanceInfo>& GetInstances() const { return Instances; }
+
+	FString DescribeNode(const uint32 TemplateId, const int32 NodeIndex) const;
+	void BuildReport(FFlowTraceReport& OutReport) const;
+
+private:
+	TArray<FFlowTraceEvent> Events;
+	TMap<uint32, FFlowTraceTemplateInfo> Templates;
+	TMap<uint32, FFlowTraceInstanceInfo> Instances;
+};
@@ -32,6 +32,7 @@ public class FlowEditor : ModuleRules
 			"EditorScriptingUtilities",
 			"EditorStyle",
 			"Engine",
+			"GameplayTags",
 			"GraphEditor",
 			"InputCore",
 			"Json",
@@ -0,0 +1,534 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Commandlets/FlowBenchmarkCommandlet.h"
+#include "FlowEditorLogChannels.h"
+#include "Graph/FlowGraph.h"
+#include "Graph/FlowGraphSchema_Actions.h"
+#include "Graph/Nodes/FlowGraphNode.h"
+
+#include "FlowAsset.h"
+#include "FlowComponent.h"
+#include "FlowSave.h"
+#include "FlowSubsystem.h"
+#include "Nodes/Operators/FlowNode_LogicalAND.h"
+#include "Nodes/Route/FlowNode_ExecutionSequence.h"
+#include "Nodes/Route/FlowNode_Reroute.h"
+#include "Nodes/Route/FlowNode_Start.h"
+#include "Nodes/Route/FlowNode_SubGraph.h"
+
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "NativeGameplayTags.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectHash.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(FlowBenchmarkCommandlet)
+
+namespace FlowBenchmark
+{
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(RegistryRootTag, "Flow.Benchmark");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(RegistryTag0, "Flow.Benchmark.0");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(RegistryTag1, "Flow.Benchmark.1");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(RegistryTag2, "Flow.Benchmark.2");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(RegistryTag3, "Flow.Benchmark.3");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(RegistryTag4, "Flow.Benchmark.4");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(RegistryTag5, "Flow.Benchmark.5");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(RegistryTag6, "Flow.Benchmark.6");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(RegistryTag7, "Flow.Benchmark.7");
+
+	static const FNativeGameplayTag* RegistryTags[] = {&RegistryTag0, &RegistryTag1, &RegistryTag2, &RegistryTag3, &RegistryTag4, &RegistryTag5, &RegistryTag6, &RegistryTag7};
+
+	// Creates transient Flow Asset through the graph schema, the same way as the asset editor does
+	struct FGraphBuilder
+	{
+		UFlowAsset* FlowAsset;
+		UEdGraph* Graph;
+		UFlowGraphNode* StartNode;
+
+		explicit FGraphBuilder(const FString& BaseName)
+			: StartNode(nullptr)
+		{
+			const FName AssetName = MakeUniqueObjectName(GetTransientPackage(), UFlowAsset::StaticClass(), *BaseName);
+			FlowAsset = NewObject<UFlowAsset>(GetTransientPackage(), AssetName, RF_Transient);
+			Graph = UFlowGraph::CreateGraph(FlowAsset);
+
+			for (UEdGraphNode* GraphNode : Graph->Nodes)
+			{
+				UFlowGraphNode* FlowGraphNode = Cast<UFlowGraphNode>(GraphNode);
+				if (FlowGraphNode && FlowGraphNode->GetFlowNodeBase() && FlowGraphNode->GetFlowNodeBase()->IsA<UFlowNode_Start>())
+				{
+					StartNode = FlowGraphNode;
+					break;
+				}
+			}
+			check(StartNode);
+		}
+
+		UEdGraphPin* GetStartPin() const
+		{
+			return StartNode->OutputPins[0];
+		}
+
+		// Adds node connected to the given output pin
+		UFlowGraphNode* AddNode(const UClass* NodeClass, UEdGraphPin* FromPin) const
+		{
+			return FFlowGraphSchemaAction_NewNode::CreateNode(Graph, FromPin, NodeClass, FVector2D::ZeroVector, false);
+		}
+
+		void Connect(UEdGraphPin* OutputPin, UEdGraphPin* InputPin) const
+		{
+			Graph->GetSchema()->TryCreateConnection(OutputPin, InputPin);
+		}
+
+		UFlowAsset* Finish() const
+		{
+			FlowAsset->HarvestNodeConnections();
+			return FlowAsset;
+		}
+	};
+
+	// Approximate memory owned by Flow Asset instances, which are always created inside the Flow Subsystem
+	static int64 CountInstanceMemory(const UFlowSubsystem* FlowSubsystem)
+	{
+		TArray<UObject*> Objects;
+		GetObjectsWithOuter(FlowSubsystem, Objects, true);
+
+		int64 Total = 0;
+		for (UObject* Object : Objects)
+		{
+			FArchiveCountMem CountMem(Object);
+			Total += CountMem.GetMax() + Object->GetClass()->GetStructureSize();
+		}
+		return Total;
+	}
+
+	// Average time of full garbage collection, nothing is purged between collections so it's dominated by reachability analysis
+	static double MeasureGarbageCollection(const int32 NumCollections)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumCollections; i++)
+		{
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+		}
+		return (FPlatformTime::Seconds() - StartTime) / NumCollections;
+	}
+
+	static double GetRate(const int32 Count, const double Seconds)
+	{
+		return Seconds > 0.0 ? Count / Seconds : 0.0;
+	}
+
+	static double GetMicroseconds(const double Seconds, const int32 Count)
+	{
+		return Count > 0 ? Seconds * 1000000.0 / Count : 0.0;
+	}
+}
+
+UFlowBenchmarkCommandlet::UFlowBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UFlowBenchmarkCommandlet::Main(const FString& Params)
+{
+	int32 NumInstances = 1000;
+	int32 ChainLength = 256;
+	int32 FanOutWidth = 128;
+	int32 NumJoins = 128;
+	int32 SubGraphDepth = 16;
+	int32 NumComponents = 1000;
+	int32 NumQueries = 10000;
+	int32 NumCollections = 10;
+
+	FParse::Value(*Params, TEXT("Instances="), NumInstances);
+	FParse::Value(*Params, TEXT("ChainLength="), ChainLength);
+	FParse::Value(*Params, TEXT("FanOut="), FanOutWidth);
+	FParse::Value(*Params, TEXT("Joins="), NumJoins);
+	FParse::Value(*Params, TEXT("SubGraphDepth="), SubGraphDepth);
+	FParse::Value(*Params, TEXT("Components="), NumComponents);
+	FParse::Value(*Params, TEXT("Queries="), NumQueries);
+	FParse::Value(*Params, TEXT("Collections="), NumCollections);
+
+	// numbered pins are indexed with uint8, Joins need one more Sequence output than the number of joins
+	NumInstances = FMath::Max(1, NumInstances);
+	ChainLength = FMath::Max(1, ChainLength);
+	FanOutWidth = FMath::Clamp(FanOutWidth, 2, static_cast<int32>(MAX_uint8));
+	NumJoins = FMath::Clamp(NumJoins, 1, static_cast<int32>(MAX_uint8) - 1);
+	SubGraphDepth = FMath::Max(1, SubGraphDepth);
+	NumCollections = FMath::Max(1, NumCollections);
+
+	FString OutputFilename;
+	if (!FParse::Value(*Params, TEXT("Output="), OutputFilename))
+	{
+		OutputFilename = FPaths::ProfilingDir() / TEXT("Flow") / FString::Printf(TEXT("FlowBenchmark-%s.json"), *FDateTime::Now().ToString());
+	}
+
+	// standalone game instance provides the world and the Flow Subsystem, without loading any map
+	UGameInstance* GameInstance = NewObject<UGameInstance>(GEngine);
+	GameInstance->AddToRoot();
+	GameInstance->InitializeStandalone();
+
+	UWorld* World = GameInstance->GetWorld();
+	UFlowSubsystem* FlowSubsystem = GameInstance->GetSubsystem<UFlowSubsystem>();
+	if (FlowSubsystem == nullptr)
+	{
+		UE_LOG(LogFlowEditor, Error, TEXT("Flow Subsystem hasn't been created for the standalone game instance"));
+		GameInstance->RemoveFromRoot();
+		return 1;
+	}
+
+	TArray<UObject*> Owners;
+	Owners.Reserve(NumInstances);
+	for (int32 i = 0; i < NumInstances; i++)
+	{
+		Owners.Emplace(World->SpawnActor<AActor>());
+	}
+
+	const TSharedRef<FJsonObject> Results = MakeShared<FJsonObject>();
+	Results->SetStringField(TEXT("Timestamp"), FDateTime::UtcNow().ToIso8601());
+	Results->SetNumberField(TEXT("Instances"), NumInstances);
+
+	// registry goes first, so components won't try restoring their state from the SaveGame loaded by the scenarios
+	Results->SetObjectField(TEXT("Registry"), RunRegistry(FlowSubsystem, NumComponents, NumQueries));
+
+	struct FScenario
+	{
+		FString Name;
+		UFlowAsset* FlowAsset;
+		int32 SignalsPerRun;
+		int32 FirstTemplate;
+	};
+
+	// signals are counted as node input activations, Start nodes are activated directly
+	TArray<FScenario> Scenarios;
+	Scenarios.Add({TEXT("Chain"), BuildChain(ChainLength), ChainLength, Templates.Num() - 1});
+	Scenarios.Add({TEXT("FanOut"), BuildFanOut(FanOutWidth), FanOutWidth + 1, Templates.Num() - 1});
+	Scenarios.Add({TEXT("Joins"), BuildJoins(NumJoins), NumJoins * 2 + 1, Templates.Num() - 1});
+
+	const int32 FirstSubGraphTemplate = Templates.Num();
+	UFlowAsset* SubGraphRoot = BuildSubGraphs(SubGraphDepth);
+	Scenarios.Add({TEXT("SubGraphs"), SubGraphRoot, SubGraphDepth + 1, FirstSubGraphTemplate});
+
+	TArray<TSharedPtr<FJsonValue>> ScenarioResults;
+	for (int32 ScenarioIndex = 0; ScenarioIndex < Scenarios.Num(); ScenarioIndex++)
+	{
+		const FScenario& Scenario = Scenarios[ScenarioIndex];
+		const int32 LastTemplate = Scenarios.IsValidIndex(ScenarioIndex + 1) ? Scenarios[ScenarioIndex + 1].FirstTemplate : Templates.Num();
+
+		int32 NumNodes = 0;
+		for (int32 i = Scenario.FirstTemplate; i < LastTemplate; i++)
+		{
+			NumNodes += Templates[i]->GetNodes().Num();
+		}
+
+		const TSharedRef<FJsonObject> ScenarioResult = RunScenario(FlowSubsystem, Scenario.FlowAsset, Scenario.SignalsPerRun, Owners);
+		ScenarioResult->SetStringField(TEXT("Name"), Scenario.Name);
+		ScenarioResult->SetNumberField(TEXT("Nodes"), NumNodes);
+
+		UE_LOG(LogFlowEditor, Display, TEXT("%s: %d nodes, %.0f signals/s, create %.2f us, %.0f bytes per instance, save %.2f us, load %.2f us"),
+			*Scenario.Name, NumNodes, ScenarioResult->GetNumberField(TEXT("SignalsPerSecond")),
+			ScenarioResult->GetNumberField(TEXT("CreateInstanceUs")), ScenarioResult->GetNumberField(TEXT("MemoryPerInstanceBytes")),
+			ScenarioResult->GetNumberField(TEXT("SaveInstanceUs")), ScenarioResult->GetNumberField(TEXT("LoadInstanceUs")));
+
+		ScenarioResults.Emplace(MakeShared<FJsonValueObject>(ScenarioResult));
+	}
+	Results->SetArrayField(TEXT("Scenarios"), ScenarioResults);
+
+	// the longest graph has the most node instances per Flow Asset instance
+	Results->SetObjectField(TEXT("GarbageCollection"), RunGarbageCollection(FlowSubsystem, Scenarios[0].FlowAsset, Owners, NumCollections));
+
+	// tear down in the reverse order
+	for (UObject* Owner : Owners)
+	{
+		CastChecked<AActor>(Owner)->Destroy();
+	}
+	Owners.Empty();
+
+	GameInstance->Shutdown();
+	World->DestroyWorld(false);
+	GEngine->DestroyWorldContext(World);
+	GameInstance->RemoveFromRoot();
+	Templates.Empty();
+
+	FString Output;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
+	FJsonSerializer::Serialize(Results, Writer);
+
+	if (!FFileHelper::SaveStringToFile(Output, *OutputFilename))
+	{
+		UE_LOG(LogFlowEditor, Error, TEXT("Couldn't write %s"), *OutputFilename);
+		return 1;
+	}
+
+	UE_LOG(LogFlowEditor, Display, TEXT("Flow Benchmark results written to %s"), *OutputFilename);
+	return 0;
+}
+
+UFlowAsset* UFlowBenchmarkCommandlet::BuildChain(const int32 Length)
+{
+	const FlowBenchmark::FGraphBuilder Builder(TEXT("FlowBenchmark_Chain"));
+
+	UEdGraphPin* FromPin = Builder.GetStartPin();
+	for (int32 i = 0; i < Length; i++)
+	{
+		FromPin = Builder.AddNode(UFlowNode_Reroute::StaticClass(), FromPin)->OutputPins[0];
+	}
+
+	return Templates.Add_GetRef(Builder.Finish());
+}
+
+UFlowAsset* UFlowBenchmarkCommandlet::BuildFanOut(const int32 Width)
+{
+	const FlowBenchmark::FGraphBuilder Builder(TEXT("FlowBenchmark_FanOut"));
+
+	UFlowGraphNode* Sequence = Builder.AddNode(UFlowNode_ExecutionSequence::StaticClass(), Builder.GetStartPin());
+	while (Sequence->OutputPins.Num() < Width)
+	{
+		Sequence->AddUserOutput();
+	}
+
+	for (UEdGraphPin* OutputPin : Sequence->OutputPins)
+	{
+		Builder.AddNode(UFlowNode_Reroute::StaticClass(), OutputPin);
+	}
+
+	return Templates.Add_GetRef(Builder.Finish());
+}
+
+UFlowAsset* UFlowBenchmarkCommandlet::BuildJoins(const int32 NumJoins)
+{
+	const FlowBenchmark::FGraphBuilder Builder(TEXT("FlowBenchmark_Joins"));
+
+	// every Sequence output completes the next LogicalAND, which was already opened by the previous one
+	UFlowGraphNode* Sequence = Builder.AddNode(UFlowNode_ExecutionSequence::StaticClass(), Builder.GetStartPin());
+	while (Sequence->OutputPins.Num() < NumJoins + 1)
+	{
+		Sequence->AddUserOutput();
+	}
+
+	UEdGraphPin* FromPin = Sequence->OutputPins[0];
+	for (int32 i = 0; i < NumJoins; i++)
+	{
+		const UFlowGraphNode* Join = Builder.AddNode(UFlowNode_LogicalAND::StaticClass(), FromPin);
+		Builder.Connect(Sequence->OutputPins[i + 1], Join->InputPins[1]);
+
+		FromPin = Join->OutputPins[0];
+	}
+
+	return Templates.Add_GetRef(Builder.Finish());
+}
+
+UFlowAsset* UFlowBenchmarkCommandlet::BuildSubGraphs(const int32 Depth)
+{
+	const FSoftObjectProperty* AssetProperty = FindFProperty<FSoftObjectProperty>(UFlowNode_SubGraph::StaticClass(), TEXT("Asset"));
+	check(AssetProperty);
+
+	// the innermost graph only passes the signal further
+	UFlowAsset* ChildAsset;
+	{
+		const FlowBenchmark::FGraphBuilder Builder(TEXT("FlowBenchmark_SubGraph"));
+		Builder.AddNode(UFlowNode_Reroute::StaticClass(), Builder.GetStartPin());
+		ChildAsset = Templates.Add_GetRef(Builder.Finish());
+	}
+
+	for (int32 Level = 0; Level < Depth; Level++)
+	{
+		const FlowBenchmark::FGraphBuilder Builder(TEXT("FlowBenchmark_SubGraph"));
+		const UFlowGraphNode* SubGraphNode = Builder.AddNode(UFlowNode_SubGraph::StaticClass(), Builder.GetStartPin());
+		AssetProperty->SetPropertyValue_InContainer(SubGraphNode->GetFlowNodeBase(), FSoftObjectPtr(ChildAsset));
+
+		ChildAsset = Templates.Add_GetRef(Builder.Finish());
+	}
+
+	return ChildAsset;
+}
+
+TSharedRef<FJsonObject> UFlowBenchmarkCommandlet::RunScenario(UFlowSubsystem* FlowSubsystem, UFlowAsset* FlowAsset, const int32 SignalsPerRun, const TArray<UObject*>& Owners) const
+{
+	const int32 NumInstances = Owners.Num();
+	const TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	const int64 MemoryBefore = FlowBenchmark::CountInstanceMemory(FlowSubsystem);
+
+	TArray<UFlowAsset*> Instances;
+	Instances.Reserve(NumInstances);
+
+	double StartTime = FPlatformTime::Seconds();
+	for (UObject* Owner : Owners)
+	{
+		Instances.Emplace(FlowSubsystem->CreateRootFlow(Owner, FlowAsset));
+	}
+	const double CreateTime = FPlatformTime::Seconds() - StartTime;
+
+	StartTime = FPlatformTime::Seconds();
+	for (UFlowAsset* Instance : Instances)
+	{
+		Instance->StartFlow();
+	}
+	const double RunTime = FPlatformTime::Seconds() - StartTime;
+
+	const int64 MemoryAfter = FlowBenchmark::CountInstanceMemory(FlowSubsystem);
+
+	// SaveGame has to survive garbage collection of the saved instances
+	UFlowSaveGame* SaveGame = NewObject<UFlowSaveGame>();
+	SaveGame->AddToRoot();
+
+	TArray<FFlowAssetSaveData> RootRecords;
+	RootRecords.Reserve(NumInstances);
+
+	StartTime = FPlatformTime::Seconds();
+	for (UFlowAsset* Instance : Instances)
+	{
+		RootRecords.Emplace(Instance->SaveInstance(SaveGame->FlowInstances));
+	}
+	const double SaveTime = FPlatformTime::Seconds() - StartTime;
+
+	TArray<uint8> SaveData;
+	UGameplayStatics::SaveGameToMemory(SaveGame, SaveData);
+
+	// restored instances reuse saved names, so the previous ones have to be destroyed first
+	FlowSubsystem->AbortActiveFlows();
+	Instances.Empty();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+	FlowSubsystem->OnGameLoaded(SaveGame);
+
+	StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumInstances; i++)
+	{
+		if (UFlowAsset* Instance = FlowSubsystem->CreateRootFlow(Owners[i], FlowAsset))
+		{
+			Instance->LoadInstance(RootRecords[i]);
+		}
+	}
+	const double LoadTime = FPlatformTime::Seconds() - StartTime;
+
+	FlowSubsystem->OnGameLoaded(nullptr);
+	FlowSubsystem->AbortActiveFlows();
+	SaveGame->RemoveFromRoot();
+
+	Result->SetNumberField(TEXT("SignalsPerRun"), SignalsPerRun);
+	Result->SetNumberField(TEXT("CreateInstanceUs"), FlowBenchmark::GetMicroseconds(CreateTime, NumInstances));
+	Result->SetNumberField(TEXT("StartFlowUs"), FlowBenchmark::GetMicroseconds(RunTime, NumInstances));
+	Result->SetNumberField(TEXT("SignalsPerSecond"), FlowBenchmark::GetRate(NumInstances * SignalsPerRun, RunTime));
+	Result->SetNumberField(TEXT("MemoryPerInstanceBytes"), static_cast<double>(MemoryAfter - MemoryBefore) / NumInstances);
+	Result->SetNumberField(TEXT("SaveInstanceUs"), FlowBenchmark::GetMicroseconds(SaveTime, NumInstances));
+	Result->SetNumberField(TEXT("SavedInstancesPerSecond"), FlowBenchmark::GetRate(NumInstances, SaveTime));
+	Result->SetNumberField(TEXT("SaveGameBytes"), SaveData.Num());
+	Result->SetNumberField(TEXT("LoadInstanceUs"), FlowBenchmark::GetMicroseconds(LoadTime, NumInstances));
+	Result->SetNumberField(TEXT("LoadedInstancesPerSecond"), FlowBenchmark::GetRate(NumInstances, LoadTime));
+
+	return Result;
+}
+
+TSharedRef<FJsonObject> UFlowBenchmarkCommandlet::RunRegistry(UFlowSubsystem* FlowSubsystem, const int32 NumComponents, const int32 NumQueries) const
+{
+	const TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+	UWorld* World = FlowSubsystem->GetWorld();
+
+	TArray<AActor*> Actors;
+	Actors.Reserve(NumComponents);
+
+	// components register to the Flow Subsystem on BeginPlay
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumComponents; i++)
+	{
+		AActor* Actor = World->SpawnActor<AActor>();
+
+		UFlowComponent* FlowComponent = NewObject<UFlowComponent>(Actor);
+		FlowComponent->IdentityTags.AddTag(FlowBenchmark::RegistryTags[i % UE_ARRAY_COUNT(FlowBenchmark::RegistryTags)]->GetTag());
+		FlowComponent->RegisterComponent();
+
+		Actor->DispatchBeginPlay();
+		Actors.Emplace(Actor);
+	}
+	const double RegisterTime = FPlatformTime::Seconds() - StartTime;
+
+	int32 NumFound = 0;
+
+	StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumQueries; i++)
+	{
+		const FGameplayTag Tag = FlowBenchmark::RegistryTags[i % UE_ARRAY_COUNT(FlowBenchmark::RegistryTags)]->GetTag();
+		NumFound += FlowSubsystem->GetFlowComponentsByTag(Tag, UFlowComponent::StaticClass(), true).Num();
+	}
+	const double ExactQueryTime = FPlatformTime::Seconds() - StartTime;
+
+	StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumQueries; i++)
+	{
+		NumFound += FlowSubsystem->GetFlowComponentsByTag(FlowBenchmark::RegistryRootTag, UFlowComponent::StaticClass(), false).Num();
+	}
+	const double ParentQueryTime = FPlatformTime::Seconds() - StartTime;
+
+	for (AActor* Actor : Actors)
+	{
+		Actor->Destroy();
+	}
+
+	Result->SetNumberField(TEXT("Components"), NumComponents);
+	Result->SetNumberField(TEXT("Queries"), NumQueries);
+	Result->SetNumberField(TEXT("ComponentsFound"), NumFound);
+	Result->SetNumberField(TEXT("RegisterComponentUs"), FlowBenchmark::GetMicroseconds(RegisterTime, NumComponents));
+	Result->SetNumberField(TEXT("ExactQueriesPerSecond"), FlowBenchmark::GetRate(NumQueries, ExactQueryTime));
+	Result->SetNumberField(TEXT("ParentTagQueriesPerSecond"), FlowBenchmark::GetRate(NumQueries, ParentQueryTime));
+
+	UE_LOG(LogFlowEditor, Display, TEXT("Registry: %d components, register %.2f us, %.0f exact queries/s, %.0f parent tag queries/s"),
+		NumComponents, Result->GetNumberField(TEXT("RegisterComponentUs")),
+		Result->GetNumberField(TEXT("ExactQueriesPerSecond")), Result->GetNumberField(TEXT("ParentTagQueriesPerSecond")));
+
+	return Result;
+}
+
+TSharedRef<FJsonObject> UFlowBenchmarkCommandlet::RunGarbageCollection(UFlowSubsystem* FlowSubsystem, UFlowAsset* FlowAsset, const TArray<UObject*>& Owners, const int32 NumCollections) const
+{
+	const TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+
+	// the first collection purges leftovers of previous scenarios
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	const double BaselineTime = FlowBenchmark::MeasureGarbageCollection(NumCollections);
+
+	// finished graph keeps all its nodes recorded, as instances do after running for a while
+	for (UObject* Owner : Owners)
+	{
+		if (UFlowAsset* Instance = FlowSubsystem->CreateRootFlow(Owner, FlowAsset))
+		{
+			Instance->StartFlow();
+		}
+	}
+
+	TArray<UObject*> InstanceObjects;
+	GetObjectsWithOuter(FlowSubsystem, InstanceObjects, true);
+
+	const double InstancesTime = FlowBenchmark::MeasureGarbageCollection(NumCollections);
+
+	FlowSubsystem->AbortActiveFlows();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+	const int32 NumInstances = Owners.Num();
+	Result->SetNumberField(TEXT("Collections"), NumCollections);
+	Result->SetNumberField(TEXT("InstanceObjects"), InstanceObjects.Num());
+	Result->SetNumberField(TEXT("BaselineCollectionMs"), BaselineTime * 1000.0);
+	Result->SetNumberField(TEXT("CollectionMs"), InstancesTime * 1000.0);
+	Result->SetNumberField(TEXT("CollectionPerInstanceUs"), FlowBenchmark::GetMicroseconds(FMath::Max(0.0, InstancesTime - BaselineTime), NumInstances));
+
+	UE_LOG(LogFlowEditor, Display, TEXT("Garbage Collection: %d instances with %d objects, %.2f ms, baseline %.2f ms, %.2f us per instance"),
+		NumInstances, InstanceObjects.Num(), Result->GetNumberField(TEXT("CollectionMs")),
+		Result->GetNumberField(TEXT("BaselineCollectionMs")), Result->GetNumberField(TEXT("CollectionPerInstanceUs")));
+
+	return Result;
+}
@@ -0,0 +1,82 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Commandlets/FlowTraceReportCommandlet.h"
+#include "FlowEditorLogChannels.h"
+#include "Types/FlowTrace.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(FlowTraceReportCommandlet)
+
+UFlowTraceReportCommandlet::UFlowTraceReportCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UFlowTraceReportCommandlet::Main(const FString& Params)
+{
+	FString TraceFilename;
+	if (!FParse::Value(*Params, TEXT("Trace="), TraceFilename))
+	{
+		UE_LOG(LogFlowEditor, Error, TEXT("Missing -Trace=<file> parameter"));
+		return 1;
+	}
+
+	FFlowTraceReader Reader;
+	if (!Reader.LoadFromFile(TraceFilename))
+	{
+		return 1;
+	}
+
+	FFlowTraceReport Report;
+	Reader.BuildReport(Report);
+
+	int32 NumTopRows = 20;
+	FParse::Value(*Params, TEXT("Top="), NumTopRows);
+
+	UE_LOG(LogFlowEditor, Display, TEXT("Flow Trace %s: %d events, %d instances of %d assets, %.3f s, %llu frames"),
+		*TraceFilename, Reader.GetEvents().Num(), Reader.GetInstances().Num(), Reader.GetTemplates().Num(), Report.Duration, Report.NumFrames);
+
+	UE_LOG(LogFlowEditor, Display, TEXT("Most activated nodes:"));
+	for (int32 i = 0; i < FMath::Min(NumTopRows, Report.Nodes.Num()); i++)
+	{
+		const FFlowTraceNodeStats& Stats = Report.Nodes[i];
+		UE_LOG(LogFlowEditor, Display, TEXT("  %s: inputs %d, outputs %d, latency avg %.3f ms, max %.3f ms"),
+			*Reader.DescribeNode(Stats.TemplateId, Stats.NodeIndex), Stats.NumInputs, Stats.NumOutputs,
+			Stats.GetAverageLatency() * 1000.0, Stats.MaxLatency * 1000.0);
+	}
+
+	UE_LOG(LogFlowEditor, Display, TEXT("Hot paths:"));
+	for (int32 i = 0; i < FMath::Min(NumTopRows, Report.HotPaths.Num()); i++)
+	{
+		const FFlowTracePathStats& Path = Report.HotPaths[i];
+		UE_LOG(LogFlowEditor, Display, TEXT("  %s -> %s: %d"),
+			*Reader.DescribeNode(Path.TemplateId, Path.FromNodeIndex), *Reader.DescribeNode(Path.TemplateId, Path.ToNodeIndex), Path.Count);
+	}
+
+	FString CsvFilename;
+	if (FParse::Value(*Params, TEXT("Csv="), CsvFilename))
+	{
+		TArray<FString> Lines;
+		Lines.Reserve(Report.Nodes.Num() + 1);
+		Lines.Add(TEXT("Node,Inputs,Outputs,AverageLatencyMs,MaxLatencyMs"));
+
+		for (const FFlowTraceNodeStats& Stats : Report.Nodes)
+		{
+			Lines.Add(FString::Printf(TEXT("%s,%d,%d,%.3f,%.3f"), *Reader.DescribeNode(Stats.TemplateId, Stats.NodeIndex),
+				Stats.NumInputs, Stats.NumOutputs, Stats.GetAverageLatency() * 1000.0, Stats.MaxLatency * 1000.0));
+		}
+
+		if (!FFileHelper::SaveStringArrayToFile(Lines, *CsvFilename))
+		{
+			UE_LOG(LogFlowEditor, Error, TEXT("Couldn't write %s"), *CsvFilename);
+			return 1;
+		}
+	}
+
+	return 0;
+}
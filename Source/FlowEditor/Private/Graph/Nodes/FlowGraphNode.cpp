@@ -1021,7 +1021,7 @@ void UFlowGraphNode::GetPinHoverText(const UEdGraphPin& Pin, FString& HoverTextO
 				for (int32 i = 0; i < PinRecords.Num(); i++)
 				{
 					HoverTextOut.Append(LINE_TERMINATOR);
-					HoverTextOut.Appendf(TEXT("%d) %s"), i + 1, *PinRecords[i].HumanReadableTime);
+					HoverTextOut.Appendf(TEXT("%d) %s"), i + 1, *PinRecords[i].GetHumanReadableTime());
 
 					switch (PinRecords[i].ActivationType)
 					{
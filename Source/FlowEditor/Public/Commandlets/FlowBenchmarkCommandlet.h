@@ -0,0 +1,41 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "FlowBenchmarkCommandlet.generated.h"
+
+class UFlowAsset;
+class UFlowSubsystem;
+class FJsonObject;
+
+/**
+ * Headless benchmark of the Flow runtime, builds synthetic graphs and runs them in a standalone game instance
+ * Covers long chains, wide ExecutionSequence fan-out, LogicalAND joins and deep SubGraph nesting, plus the component registry and garbage collection
+ * Results are written as JSON, so they can be tracked between revisions
+ * Usage: -run=FlowBenchmark -nullrhi [-Output=<file>] [-Instances=] [-ChainLength=] [-FanOut=] [-Joins=] [-SubGraphDepth=] [-Components=] [-Queries=] [-Collections=]
+ */
+UCLASS()
+class FLOWEDITOR_API UFlowBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UFlowBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	UFlowAsset* BuildChain(const int32 Length);
+	UFlowAsset* BuildFanOut(const int32 Width);
+	UFlowAsset* BuildJoins(const int32 NumJoins);
+	UFlowAsset* BuildSubGraphs(const int32 Depth);
+
+	TSharedRef<FJsonObject> RunScenario(UFlowSubsystem* FlowSubsystem, UFlowAsset* FlowAsset, const int32 SignalsPerRun, const TArray<UObject*>& Owners) const;
+	TSharedRef<FJsonObject> RunRegistry(UFlowSubsystem* FlowSubsystem, const int32 NumComponents, const int32 NumQueries) const;
+	TSharedRef<FJsonObject> RunGarbageCollection(UFlowSubsystem* FlowSubsystem, UFlowAsset* FlowAsset, const TArray<UObject*>& Owners, const int32 NumCollections) const;
+
+	// Templates built by this run, kept alive until the benchmark ends
+	UPROPERTY()
+	TArray<UFlowAsset*> Templates;
+};
@@ -0,0 +1,21 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "FlowTraceReportCommandlet.generated.h"
+
+/**
+ * Summarizes the file recorded by Flow Trace Recorder: per-node activation counts, latencies and the most frequent paths
+ * Usage: -run=FlowTraceReport -Trace=<file> [-Csv=<file>] [-Top=<number of rows>]
+ */
+UCLASS()
+class FLOWEDITOR_API UFlowTraceReportCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UFlowTraceReportCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};